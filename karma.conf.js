@@ -27,6 +27,7 @@ module.exports = config => {
       'src/gui/html/js/game.js',
       'src/gui/html/js/query.js',
       'src/gui/html/js/state.js',
+      'src/gui/html/js/subscribe.js',
       'src/gui/html/js/translator.js',
       'src/gui/html/js/updateExists.js',
       'src/tests/gui/html/js/*.js'
@@ -93,6 +93,7 @@ function createAppArchive(rootPath, releasePath, tempPath, destPath) {
   if (os.platform() === 'win32') {
     binaries = [
       'LOOT.exe',
+      'loot-cli.exe',
       'loot_api.dll',
       'chrome_elf.dll',
       'd3dcompiler_47.dll',
@@ -110,6 +111,7 @@ function createAppArchive(rootPath, releasePath, tempPath, destPath) {
   } else {
     binaries = [
       'LOOT',
+      'loot-cli',
       'libloot_api.so',
       'chrome-sandbox',
       'libcef.so',
@@ -0,0 +1,363 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+
+#include "cli/server.h"
+#include "gui/cef/query/query_factory.h"
+#include "gui/state/loot_paths.h"
+#include "gui/state/loot_state.h"
+
+namespace loot {
+// Takes the same options as the LOOT application, plus the verb to run.
+struct CommandLineOptions {
+  std::string verb;
+  std::string defaultGame;
+  std::string lootDataPath;
+  std::string gameAppDataPath;
+  // Only used by the batch verb.
+  std::vector<std::string> batchGames;
+  std::vector<std::string> batchProfiles;
+  bool applySortedLoadOrder;
+  // Only used by the serve verb.
+  unsigned short port;
+  // Only used by the check-modlists verb.
+  std::vector<std::string> manifests;
+  std::string workPath;
+  unsigned int threads;
+  bool isValid;
+
+  CommandLineOptions(int argc, const char *const *argv) :
+      applySortedLoadOrder(false),
+      port(0),
+      threads(0),
+      isValid(true) {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+
+      if (!boost::starts_with(arg, "--")) {
+        isValid = isValid && verb.empty();
+        verb = arg;
+        continue;
+      }
+
+      if (arg == "--apply") {
+        applySortedLoadOrder = true;
+        continue;
+      }
+
+      // Accept both "--name=value" and "--name value".
+      std::string name = arg.substr(2);
+      std::string value;
+      auto pos = name.find('=');
+      if (pos != std::string::npos) {
+        value = name.substr(pos + 1);
+        name = name.substr(0, pos);
+      } else if (i + 1 < argc) {
+        value = argv[++i];
+      } else {
+        isValid = false;
+      }
+
+      if (name == "game") {
+        defaultGame = value;
+      } else if (name == "loot-data-path") {
+        lootDataPath = value;
+      } else if (name == "game-appdata-path") {
+        gameAppDataPath = value;
+      } else if (name == "games") {
+        boost::split(batchGames, value, boost::is_any_of(","));
+      } else if (name == "profile") {
+        // Paths may contain commas, so each profile is given separately.
+        batchProfiles.push_back(value);
+      } else if (name == "manifest") {
+        manifests.push_back(value);
+      } else if (name == "work-path") {
+        workPath = value;
+      } else if (name == "threads") {
+        try {
+          threads = boost::numeric_cast<unsigned int>(std::stoul(value));
+        } catch (std::exception &) {
+          isValid = false;
+        }
+      } else if (name == "port") {
+        try {
+          port = boost::numeric_cast<unsigned short>(std::stoul(value));
+        } catch (std::exception &) {
+          isValid = false;
+        }
+      } else {
+        isValid = false;
+      }
+    }
+
+    isValid = isValid && !verb.empty();
+  }
+};
+
+void printUsage(const char *program) {
+  std::cerr
+      << "Usage: " << program
+      << " <sort|apply|validate|redate|update-masterlist|batch|serve|"
+         "check-modlists>"
+         " [--game=<folder>] [--loot-data-path=<path>]"
+         " [--game-appdata-path=<path>] [--games=<folder>,...]"
+         " [--profile=<path>]... [--apply] [--port=<port>]"
+         " [--manifest=<path>]... [--work-path=<path>] [--threads=<count>]"
+      << std::endl
+      << std::endl
+      << "  sort               Sort the load order and print the result."
+      << std::endl
+      << "  apply              Sort the load order and save the result."
+      << std::endl
+      << "  validate           Check the current load order and print any "
+         "problems."
+      << std::endl
+      << "  redate             Redate plugins to match the load order "
+         "(Skyrim and Skyrim SE only)."
+      << std::endl
+      << "  update-masterlist  Update the masterlist and print the game data "
+         "if it changed."
+      << std::endl
+      << "  batch              Sort and validate all installed games, or "
+         "those given by"
+      << std::endl
+      << "                     --games, at once. Sorted load orders are only "
+         "saved if"
+      << std::endl
+      << "                     --apply is given. If --profile is given, the "
+         "game's"
+      << std::endl
+      << "                     profiles with load order files in the given "
+         "folders are"
+      << std::endl
+      << "                     processed instead." << std::endl
+      << "  serve              Serve queries as JSON-RPC requests on the "
+         "given local port,"
+      << std::endl
+      << "                     or on a free port if none is given."
+      << std::endl
+      << "  check-modlists     Check and sort the modlists described by the "
+         "given"
+      << std::endl
+      << "                     manifests, without needing the games to be "
+         "installed."
+      << std::endl;
+}
+
+// Collects the outcome of a query that is run on the current thread.
+class QueryOutcome : public QueryCallback {
+public:
+  QueryOutcome() : isSuccess_(false) {}
+
+  void Success(const std::string &response) {
+    isSuccess_ = true;
+    response_ = response;
+  }
+
+  void Failure(const std::string &errorMessage) { response_ = errorMessage; }
+
+  std::string getResponse() const {
+    if (!isSuccess_)
+      throw std::runtime_error(response_);
+
+    return response_;
+  }
+
+private:
+  bool isSuccess_;
+  std::string response_;
+};
+
+// Runs a query created by the same factory as the UI and server use, so that
+// all three accept the same requests.
+std::string runQuery(LootState &state, const nlohmann::json &request) {
+  auto query = createQuery(state, nullptr, request);
+  if (!query)
+    throw std::invalid_argument("Unrecognised query: " + request.dump());
+
+  QueryOutcome outcome;
+  query->execute(outcome);
+
+  return outcome.getResponse();
+}
+
+// Loads the game's plugin headers and metadata, as the UI does when a game
+// is first selected.
+void loadGameData(LootState &state) {
+  state.getCurrentGame().LoadAllInstalledPlugins(true);
+  state.getCurrentGame().LoadMetadata();
+}
+
+std::string runVerb(LootState &state, const CommandLineOptions &options) {
+  const std::string &verb = options.verb;
+  if (verb == "check-modlists") {
+    return runQuery(state,
+                    {
+                      { "name", "validateModlists" },
+                      { "manifests", options.manifests },
+                      { "workPath", options.workPath },
+                      { "threads", options.threads },
+                    });
+  } else if (verb == "batch") {
+    return runQuery(state,
+                    {
+                      { "name", "runGameBatch" },
+                      { "games", options.batchGames },
+                      { "profiles", options.batchProfiles },
+                      { "apply", options.applySortedLoadOrder },
+                    });
+  } else if (verb == "sort" || verb == "apply") {
+    loadGameData(state);
+    auto response = runQuery(state, { { "name", "sortPlugins" } });
+
+    if (verb == "apply") {
+      auto sorted = nlohmann::json::parse(response).at("plugins");
+      std::vector<std::string> plugins;
+      for (const auto &plugin : sorted) {
+        plugins.push_back(plugin.at("name"));
+      }
+
+      // An empty list of plugins means that sorting failed.
+      if (plugins.empty())
+        throw std::runtime_error("Sorting failed: " + response);
+
+      runQuery(state,
+               {
+                 { "name", "applySort" },
+                 { "pluginNames", { { "plugins", plugins } } },
+               });
+    }
+
+    return response;
+  } else if (verb == "validate") {
+    loadGameData(state);
+    return runQuery(state, { { "name", "validateLoadOrder" } });
+  } else if (verb == "redate") {
+    runQuery(state, { { "name", "redatePlugins" } });
+    return "{}";
+  } else if (verb == "update-masterlist") {
+    // The game data includes the plugins, so load them first.
+    loadGameData(state);
+    return runQuery(state, { { "name", "updateMasterlist" } });
+  }
+
+  throw std::invalid_argument("Unrecognised verb: " + verb);
+}
+}
+
+int main(int argc, char *argv[]) {
+  const auto cliOptions = loot::CommandLineOptions(argc, argv);
+  if (!cliOptions.isValid) {
+    loot::printUsage(argv[0]);
+    return 1;
+  }
+
+  loot::LootPaths::initialise(cliOptions.lootDataPath);
+
+  loot::LootState state;
+  state.init(cliOptions.defaultGame, cliOptions.gameAppDataPath);
+  for (const auto &error : state.getInitErrors()) {
+    std::cerr << error << std::endl;
+  }
+
+  // Modlists are checked against their own staged installs, so they don't
+  // need any game to be installed.
+  if (cliOptions.verb == "check-modlists") {
+    try {
+      auto response = loot::runVerb(state, cliOptions);
+      std::cout << response << std::endl;
+
+      auto json = nlohmann::json::parse(response);
+      for (const auto &modlist : json.at("modlists")) {
+        if (modlist.count("error") != 0)
+          return 1;
+      }
+
+      return json.at("valid").get<bool>() ? 0 : 2;
+    } catch (std::exception &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  if (!state.getInitErrors().empty())
+    return 1;
+
+  // The application falls back to another game if the given game isn't
+  // installed, but scripts shouldn't act on a game they didn't ask for.
+  if (!cliOptions.defaultGame.empty() &&
+      !boost::iequals(state.getCurrentGame().FolderName(),
+                      cliOptions.defaultGame)) {
+    std::cerr << "The game \"" << cliOptions.defaultGame
+              << "\" is not installed." << std::endl;
+    return 1;
+  }
+
+  try {
+    if (cliOptions.verb == "serve") {
+      loot::QueryServer server(state, cliOptions.port);
+
+      // Print the port so that clients can find it if it was chosen for us,
+      // and the token that they must authenticate with.
+      nlohmann::json json = {
+        { "port", server.port() },
+        { "token", server.token() },
+      };
+      std::cout << json.dump() << std::endl;
+
+      server.run();
+      return 0;
+    }
+
+    auto response = loot::runVerb(state, cliOptions);
+    std::cout << response << std::endl;
+
+    if (cliOptions.verb == "batch") {
+      auto games = nlohmann::json::parse(response).at("games");
+      for (const auto &game : games) {
+        if (game.count("error") != 0)
+          return 1;
+      }
+    }
+
+    if ((cliOptions.verb == "validate" || cliOptions.verb == "batch") &&
+        !nlohmann::json::parse(response).at("valid").get<bool>())
+      return 2;
+  } catch (std::exception &e) {
+    auto logger = state.getLogger();
+    if (logger) {
+      logger->error("Failed to run \"{}\": {}", cliOptions.verb, e.what());
+    }
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,577 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "cli/server.h"
+
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <istream>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+#include "gui/cef/query/query_factory.h"
+#include "gui/state/logging.h"
+
+using boost::asio::ip::tcp;
+using std::lock_guard;
+using std::mutex;
+
+namespace loot {
+namespace {
+// Error codes defined by the JSON-RPC 2.0 specification.
+const int parseError = -32700;
+const int invalidRequest = -32600;
+const int methodNotFound = -32601;
+const int invalidParams = -32602;
+// The specification reserves -32000 to -32099 for implementation-defined
+// server errors.
+const int queryFailed = -32000;
+const int unauthenticated = -32001;
+
+// Requests longer than this are rejected, and their connection closed.
+const size_t maxRequestSize = 16 * 1024 * 1024;
+
+// The queries that clients may run. Queries that only make sense for LOOT's
+// window, or that change its settings or run other programs, such as those
+// that use the clipboard or open files, are left out.
+const std::set<std::string> servedQueries = {
+  "applySort",
+  "cancelSort",
+  "changeGame",
+  "clearAllMetadata",
+  "clearPluginMetadata",
+  "discardUnappliedChanges",
+  "getConflictMatrix",
+  "getConflictingPlugins",
+  "getGameData",
+  "getGameTypes",
+  "getInitErrors",
+  "getInstalledGames",
+  "getLanguages",
+  "getMemoryUsage",
+  "getPerformanceStats",
+  "getSettings",
+  "getVersion",
+  "redatePlugins",
+  "runGameBatch",
+  "sortPlugins",
+  "updateMasterlist",
+  "validateLoadOrder",
+  "validateModlists",
+};
+
+std::string generateToken() {
+  std::random_device device;
+  std::ostringstream stream;
+  for (int i = 0; i < 4; ++i) {
+    stream << std::hex << std::setw(8) << std::setfill('0') << device();
+  }
+  return stream.str();
+}
+
+// Compares the whole of both strings, so that how long a comparison takes
+// doesn't reveal how much of a guessed token is right.
+bool isTokenEqual(const std::string& given, const std::string& expected) {
+  if (given.size() != expected.size()) {
+    return false;
+  }
+
+  unsigned char difference = 0;
+  for (size_t i = 0; i < given.size(); ++i) {
+    difference |= given[i] ^ expected[i];
+  }
+  return difference == 0;
+}
+
+nlohmann::json makeError(const nlohmann::json& id,
+                         int code,
+                         const std::string& message) {
+  return {
+    { "jsonrpc", "2.0" },
+    { "id", id },
+    { "error",
+      {
+        { "code", code },
+        { "message", message },
+      } },
+  };
+}
+
+nlohmann::json makeNotification(const std::string& method,
+                                nlohmann::json params) {
+  return {
+    { "jsonrpc", "2.0" },
+    { "method", method },
+    { "params", params },
+  };
+}
+}
+
+// Reads requests from a client, and writes responses and notifications back
+// in the order that they're sent. Only used on the network thread.
+class ServerConnection
+    : public std::enable_shared_from_this<ServerConnection> {
+public:
+  ServerConnection(QueryServer& server) :
+      server_(server),
+      socket_(server.network_),
+      buffer_(maxRequestSize),
+      isAuthenticated_(false) {}
+
+  tcp::socket& socket() { return socket_; }
+
+  void start() { read(); }
+
+  bool isAuthenticated() const { return isAuthenticated_; }
+
+  void authenticate() { isAuthenticated_ = true; }
+
+  void send(const nlohmann::json& message) {
+    bool isWriting = !writeQueue_.empty();
+    writeQueue_.push_back(message.dump() + "\n");
+
+    if (!isWriting) {
+      write();
+    }
+  }
+
+  void close() {
+    boost::system::error_code error;
+    socket_.close(error);
+  }
+
+private:
+  void read() {
+    auto self = shared_from_this();
+    boost::asio::async_read_until(
+        socket_,
+        buffer_,
+        '\n',
+        [this, self](const boost::system::error_code& error, size_t) {
+          if (error) {
+            disconnect(error);
+            return;
+          }
+
+          std::istream stream(&buffer_);
+          std::string line;
+          std::getline(stream, line);
+          if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+          }
+
+          if (!line.empty()) {
+            server_.handleRequest(self, line);
+          }
+
+          read();
+        });
+  }
+
+  void write() {
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        socket_,
+        boost::asio::buffer(writeQueue_.front()),
+        [this, self](const boost::system::error_code& error, size_t) {
+          if (error) {
+            writeQueue_.clear();
+            disconnect(error);
+            return;
+          }
+
+          writeQueue_.pop_front();
+          if (!writeQueue_.empty()) {
+            write();
+          }
+        });
+  }
+
+  void disconnect(const boost::system::error_code& error) {
+    if (error != boost::asio::error::operation_aborted) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug("Closing server connection: {}", error.message());
+      }
+    }
+
+    close();
+    server_.connections_.erase(shared_from_this());
+  }
+
+  QueryServer& server_;
+  tcp::socket socket_;
+  boost::asio::streambuf buffer_;
+  std::deque<std::string> writeQueue_;
+  bool isAuthenticated_;
+};
+
+// Sends events to all connected clients as notifications. As with the UI's
+// event channel, progress for the same phase is rate-limited and
+// invalidations are batched.
+class ServerEventSink : public EventSink {
+public:
+  ServerEventSink(QueryServer& server) :
+      server_(server),
+      hasPendingProgress_(false) {}
+
+  void sendProgress(const ProgressEvent& event) {
+    lock_guard<mutex> guard(mutex_);
+
+    if (event.phase != lastPhase_ ||
+        (event.total > 0 && event.done >= event.total) || canSendNow()) {
+      sendProgressNow(event);
+    } else {
+      pendingProgress_ = event;
+      hasPendingProgress_ = true;
+    }
+  }
+
+  void sendInvalidation(const std::string& scope) {
+    lock_guard<mutex> guard(mutex_);
+
+    pendingInvalidations_.insert(scope);
+
+    if (canSendNow()) {
+      sendInvalidationsNow();
+    }
+  }
+
+  void flush() {
+    lock_guard<mutex> guard(mutex_);
+
+    if (hasPendingProgress_) {
+      sendProgressNow(pendingProgress_);
+    }
+
+    sendInvalidationsNow();
+  }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  bool canSendNow() const {
+    return Clock::now() - lastSent_ >= std::chrono::milliseconds(100);
+  }
+
+  void sendProgressNow(const ProgressEvent& event) {
+    hasPendingProgress_ = false;
+    lastPhase_ = event.phase;
+
+    send(makeNotification("progress",
+                          {
+                            { "phase", event.phase },
+                            { "message", event.message },
+                            { "done", event.done },
+                            { "total", event.total },
+                            { "plugin", event.plugin },
+                            { "background", event.background },
+                          }));
+  }
+
+  void sendInvalidationsNow() {
+    if (pendingInvalidations_.empty()) {
+      return;
+    }
+
+    send(makeNotification("invalidate",
+                          {
+                            { "scopes", pendingInvalidations_ },
+                          }));
+
+    pendingInvalidations_.clear();
+  }
+
+  void send(const nlohmann::json& notification) {
+    lastSent_ = Clock::now();
+
+    QueryServer& server = server_;
+    server_.network_.post(
+        [&server, notification]() { server.broadcast(notification); });
+  }
+
+  QueryServer& server_;
+
+  Clock::time_point lastSent_;
+  std::string lastPhase_;
+  bool hasPendingProgress_;
+  ProgressEvent pendingProgress_;
+  std::set<std::string> pendingInvalidations_;
+
+  mutex mutex_;
+};
+
+namespace {
+// Passes a query's outcome from the backend thread to the network thread, to
+// be sent to the client that requested it.
+class ResponseCallback : public QueryCallback {
+public:
+  ResponseCallback(boost::asio::io_service& network,
+                   std::shared_ptr<ServerConnection> connection,
+                   const nlohmann::json& id,
+                   bool isNotification) :
+      network_(network),
+      connection_(connection),
+      id_(id),
+      isNotification_(isNotification) {}
+
+  void Success(const std::string& response) {
+    // Queries respond with serialised JSON, or nothing at all.
+    nlohmann::json result;
+    if (!response.empty()) {
+      try {
+        result = nlohmann::json::parse(response);
+      } catch (std::exception&) {
+        result = response;
+      }
+    }
+
+    send({
+      { "jsonrpc", "2.0" },
+      { "id", id_ },
+      { "result", result },
+    });
+  }
+
+  void Failure(const std::string& errorMessage) {
+    send(makeError(id_, queryFailed, errorMessage));
+  }
+
+private:
+  void send(const nlohmann::json& response) {
+    if (isNotification_) {
+      return;
+    }
+
+    auto connection = connection_;
+    network_.post([connection, response]() { connection->send(response); });
+  }
+
+  boost::asio::io_service& network_;
+  std::shared_ptr<ServerConnection> connection_;
+  nlohmann::json id_;
+  bool isNotification_;
+};
+}
+
+QueryServer::QueryServer(LootState& state, unsigned short port) :
+    state_(state),
+    token_(generateToken()),
+    events_(std::make_shared<ServerEventSink>(*this)),
+    acceptor_(network_,
+              tcp::endpoint(boost::asio::ip::address_v4::loopback(), port)),
+    signals_(network_, SIGINT, SIGTERM),
+    backendWork_(new boost::asio::io_service::work(backend_)),
+    backendThread_([this]() { backend_.run(); }) {
+  signals_.async_wait(
+      [this](const boost::system::error_code& error, int) {
+        if (!error) {
+          stop();
+        }
+      });
+
+  accept();
+}
+
+QueryServer::~QueryServer() {
+  // Let the running query finish, but drop any that are still queued.
+  backendWork_.reset();
+  backend_.stop();
+  backendThread_.join();
+}
+
+unsigned short QueryServer::port() const {
+  return acceptor_.local_endpoint().port();
+}
+
+std::string QueryServer::token() const { return token_; }
+
+void QueryServer::run() {
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("Serving queries on port {}", port());
+  }
+
+  network_.run();
+
+  if (logger) {
+    logger->info("Stopped serving queries");
+  }
+}
+
+void QueryServer::accept() {
+  auto connection = std::make_shared<ServerConnection>(*this);
+  acceptor_.async_accept(
+      connection->socket(),
+      [this, connection](const boost::system::error_code& error) {
+        if (error == boost::asio::error::operation_aborted) {
+          return;
+        }
+
+        if (!error) {
+          connections_.insert(connection);
+          connection->start();
+        }
+
+        accept();
+      });
+}
+
+void QueryServer::stop() {
+  boost::system::error_code error;
+  acceptor_.close(error);
+  signals_.cancel(error);
+
+  for (const auto& connection : connections_) {
+    connection->close();
+  }
+  connections_.clear();
+
+  network_.stop();
+}
+
+void QueryServer::handleRequest(std::shared_ptr<ServerConnection> connection,
+                                const std::string& line) {
+  auto logger = getLogger();
+  if (logger) {
+    logger->trace("Received server request: {}", line);
+  }
+
+  nlohmann::json request;
+  try {
+    request = nlohmann::json::parse(line);
+  } catch (std::exception& e) {
+    connection->send(makeError(nullptr, parseError, e.what()));
+    return;
+  }
+
+  if (!request.is_object() ||
+      request.value("jsonrpc", std::string()) != "2.0" ||
+      request.count("method") == 0 || !request.at("method").is_string()) {
+    nlohmann::json id;
+    if (request.is_object()) {
+      id = request.value("id", nlohmann::json());
+    }
+    connection->send(makeError(id, invalidRequest, "Invalid request"));
+    return;
+  }
+
+  // Requests without an ID are notifications, which get no response.
+  const bool isNotification = request.count("id") == 0;
+  const nlohmann::json id = request.value("id", nlohmann::json());
+  const std::string method = request.at("method");
+
+  nlohmann::json params = request.value("params", nlohmann::json::object());
+  if (!params.is_object()) {
+    if (!isNotification) {
+      connection->send(
+          makeError(id, invalidParams, "Params must be given by name"));
+    }
+    return;
+  }
+  params["name"] = method;
+
+  // Nothing else is accepted until the client has given the token, which
+  // only whoever started the server can know.
+  if (method == "authenticate") {
+    if (!params.value("token", nlohmann::json()).is_string() ||
+        !isTokenEqual(params.at("token"), token_)) {
+      if (logger) {
+        logger->warn("Rejected a server connection's authentication token");
+      }
+      if (!isNotification) {
+        connection->send(makeError(id, unauthenticated, "Invalid token"));
+      }
+      return;
+    }
+
+    connection->authenticate();
+    ResponseCallback(network_, connection, id, isNotification).Success("");
+    return;
+  }
+
+  if (!connection->isAuthenticated()) {
+    if (!isNotification) {
+      connection->send(makeError(id, unauthenticated, "Not authenticated"));
+    }
+    return;
+  }
+
+  // Queries run one at a time on the backend thread, so a cancellation has to
+  // be handled here or it would wait for the query it is meant to cancel.
+  if (method == "cancelConflictMatrix") {
+    state_.cancelConflictMatrix();
+    ResponseCallback(network_, connection, id, isNotification).Success("");
+    return;
+  }
+
+  if (servedQueries.count(method) == 0) {
+    if (!isNotification) {
+      connection->send(
+          makeError(id, methodNotFound, "Method not found: " + method));
+    }
+    return;
+  }
+
+  std::unique_ptr<Query> query;
+  try {
+    query = createQuery(state_, events_, params);
+  } catch (std::exception& e) {
+    if (!isNotification) {
+      connection->send(makeError(id, invalidParams, e.what()));
+    }
+    return;
+  }
+
+  if (!query) {
+    if (!isNotification) {
+      connection->send(
+          makeError(id, methodNotFound, "Method not found: " + method));
+    }
+    return;
+  }
+
+  // Don't let asking for the stats push out the stats being asked for.
+  if (method != "getPerformanceStats")
+    query->recordPerformance(method, state_.getPerformanceStats());
+
+  // Older versions of Asio require handlers to be copyable.
+  std::shared_ptr<Query> sharedQuery(std::move(query));
+  auto& network = network_;
+  backend_.post([&network, connection, id, isNotification, sharedQuery]() {
+    ResponseCallback callback(network, connection, id, isNotification);
+    sharedQuery->execute(callback);
+  });
+}
+
+void QueryServer::broadcast(const nlohmann::json& notification) {
+  for (const auto& connection : connections_) {
+    if (connection->isAuthenticated()) {
+      connection->send(notification);
+    }
+  }
+}
+}
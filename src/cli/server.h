@@ -0,0 +1,96 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_CLI_SERVER
+#define LOOT_CLI_SERVER
+
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include "gui/state/loot_state.h"
+
+#undef min
+#include <json.hpp>
+
+namespace loot {
+class ServerConnection;
+class ServerEventSink;
+
+// Serves the application's queries to local clients as JSON-RPC 2.0 requests
+// and responses, one JSON object per line, over TCP. The server only listens
+// on the loopback interface, and each connection must first send an
+// "authenticate" request giving the token that the server was started with.
+// Only queries that don't touch the desktop or LOOT's settings are served.
+// Queries are run one at a time, in the order they're received, on a single
+// backend thread, so clients see the same state transitions as the UI.
+// Progress and invalidation events are sent to all authenticated clients as
+// "progress" and "invalidate" notifications.
+class QueryServer {
+public:
+  // If port is 0, the operating system chooses a free port.
+  QueryServer(LootState& state, unsigned short port);
+  ~QueryServer();
+
+  unsigned short port() const;
+
+  // A random token generated for this run of the server.
+  std::string token() const;
+
+  // Serves requests until the process is interrupted or terminated.
+  void run();
+
+private:
+  friend class ServerConnection;
+  friend class ServerEventSink;
+
+  void accept();
+  void stop();
+
+  // Called on the network thread.
+  void handleRequest(std::shared_ptr<ServerConnection> connection,
+                     const std::string& line);
+  void broadcast(const nlohmann::json& notification);
+
+  LootState& state_;
+  const std::string token_;
+  std::shared_ptr<ServerEventSink> events_;
+
+  boost::asio::io_service network_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  boost::asio::signal_set signals_;
+  std::set<std::shared_ptr<ServerConnection>> connections_;
+
+  // Queries are posted to the backend, which keeps running until the work
+  // object is destroyed.
+  boost::asio::io_service backend_;
+  std::unique_ptr<boost::asio::io_service::work> backendWork_;
+  std::thread backendThread_;
+};
+}
+
+#endif
@@ -0,0 +1,162 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#include "gui/cef/event_channel.h"
+
+#include "gui/state/logging.h"
+
+using std::lock_guard;
+using std::mutex;
+
+namespace loot {
+const std::chrono::milliseconds EventChannel::minInterval(100);
+
+EventChannel::EventChannel() : queryId_(0), hasPendingProgress_(false) {}
+
+void EventChannel::subscribe(
+    int64 queryId,
+    CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) {
+  lock_guard<mutex> guard(mutex_);
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("UI subscribed to backend events with query ID {}", queryId);
+  }
+
+  queryId_ = queryId;
+  callback_ = callback;
+}
+
+void EventChannel::unsubscribe(int64 queryId) {
+  lock_guard<mutex> guard(mutex_);
+
+  if (queryId != queryId_) {
+    return;
+  }
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("UI unsubscribed from backend events");
+  }
+
+  queryId_ = 0;
+  callback_ = nullptr;
+}
+
+void EventChannel::sendProgress(const ProgressEvent& event) {
+  lock_guard<mutex> guard(mutex_);
+
+  // Background progress is rate-limited separately and never left pending, so
+  // that it can't displace or delay progress for a query the UI is waiting on.
+  if (event.background) {
+    auto now = Clock::now();
+    if ((event.total > 0 && event.done >= event.total) ||
+        now - lastBackgroundSent_ >= minInterval) {
+      lastBackgroundSent_ = now;
+      send(toJson(event));
+    }
+    return;
+  }
+
+  // Phase changes and completed phases are always sent immediately, so that
+  // the UI never gets stuck displaying a stale phase.
+  if (event.phase != lastPhase_ ||
+      (event.total > 0 && event.done >= event.total) || canSendNow()) {
+    sendProgressNow(event);
+  } else {
+    pendingProgress_ = event;
+    hasPendingProgress_ = true;
+  }
+}
+
+void EventChannel::sendInvalidation(const std::string& scope) {
+  lock_guard<mutex> guard(mutex_);
+
+  pendingInvalidations_.insert(scope);
+
+  if (canSendNow()) {
+    sendInvalidationsNow();
+  }
+}
+
+void EventChannel::flush() {
+  lock_guard<mutex> guard(mutex_);
+
+  if (hasPendingProgress_) {
+    sendProgressNow(pendingProgress_);
+  }
+
+  sendInvalidationsNow();
+}
+
+bool EventChannel::canSendNow() const {
+  return Clock::now() - lastSent_ >= minInterval;
+}
+
+void EventChannel::sendProgressNow(const ProgressEvent& event) {
+  hasPendingProgress_ = false;
+  lastPhase_ = event.phase;
+
+  send(toJson(event));
+}
+
+nlohmann::json EventChannel::toJson(const ProgressEvent& event) {
+  return {
+    { "type", "progress" },
+    { "phase", event.phase },
+    { "message", event.message },
+    { "done", event.done },
+    { "total", event.total },
+    { "plugin", event.plugin },
+    { "background", event.background },
+  };
+}
+
+void EventChannel::sendInvalidationsNow() {
+  if (pendingInvalidations_.empty()) {
+    return;
+  }
+
+  send({
+    { "type", "invalidate" },
+    { "scopes", pendingInvalidations_ },
+  });
+
+  pendingInvalidations_.clear();
+}
+
+void EventChannel::send(const nlohmann::json& json) {
+  lastSent_ = Clock::now();
+
+  if (!callback_) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->trace("No UI subscription, dropping event: {}", json.dump());
+    }
+    return;
+  }
+
+  callback_->Success(json.dump());
+}
+}
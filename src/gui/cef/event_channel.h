@@ -0,0 +1,82 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_GUI_EVENT_CHANNEL
+#define LOOT_GUI_EVENT_CHANNEL
+
+#include <chrono>
+#include <mutex>
+#include <set>
+
+#include <include/wrapper/cef_message_router.h>
+
+#include "gui/state/event_sink.h"
+
+#undef min
+#include <json.hpp>
+
+namespace loot {
+// Pushes events to the UI through a persistent CEF query that the UI opens
+// once at startup. Progress events for the same phase are rate-limited, and
+// invalidations are batched, so that tight loops can report progress without
+// flooding the renderer process.
+class EventChannel : public EventSink {
+public:
+  EventChannel();
+
+  void subscribe(int64 queryId,
+                 CefRefPtr<CefMessageRouterBrowserSide::Callback> callback);
+  void unsubscribe(int64 queryId);
+
+  void sendProgress(const ProgressEvent& event);
+  void sendInvalidation(const std::string& scope);
+  void flush();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  static const std::chrono::milliseconds minInterval;
+
+  static nlohmann::json toJson(const ProgressEvent& event);
+
+  bool canSendNow() const;
+  void sendProgressNow(const ProgressEvent& event);
+  void sendInvalidationsNow();
+  void send(const nlohmann::json& json);
+
+  CefRefPtr<CefMessageRouterBrowserSide::Callback> callback_;
+  int64 queryId_;
+
+  Clock::time_point lastSent_;
+  Clock::time_point lastBackgroundSent_;
+  std::string lastPhase_;
+  bool hasPendingProgress_;
+  ProgressEvent pendingProgress_;
+  std::set<std::string> pendingInvalidations_;
+
+  std::mutex mutex_;
+};
+}
+
+#endif
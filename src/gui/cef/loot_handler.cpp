@@ -40,7 +40,9 @@
 #include "gui/state/loot_paths.h"
 
 namespace loot {
-LootHandler::LootHandler(LootState& lootState) : lootState_(lootState) {}
+LootHandler::LootHandler(LootState& lootState) :
+    lootState_(lootState),
+    events_(std::make_shared<EventChannel>()) {}
 
 // CefClient methods
 //------------------
@@ -72,7 +74,7 @@ void LootHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
   CefMessageRouterConfig config;
   browser_side_router_ = CefMessageRouterBrowserSide::Create(config);
 
-  browser_side_router_->AddHandler(new QueryHandler(lootState_), false);
+  browser_side_router_->AddHandler(new QueryHandler(lootState_, events_), false);
 }
 
 bool LootHandler::DoClose(CefRefPtr<CefBrowser> browser) {
@@ -30,6 +30,7 @@
 #include <include/cef_client.h>
 #include <include/wrapper/cef_message_router.h>
 
+#include "gui/cef/event_channel.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
@@ -88,6 +89,7 @@ private:
   // List of existing browser windows. Only accessed on the CEF UI thread.
   BrowserList browser_list_;
   CefRefPtr<CefMessageRouterBrowserSide> browser_side_router_;
+  std::shared_ptr<EventChannel> events_;
 
   LootState& lootState_;
 
@@ -25,20 +25,32 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_DERIVED_PLUGIN_METADATA
 #define LOOT_GUI_QUERY_DERIVED_PLUGIN_METADATA
 
+#include <iterator>
+
 #include <json.hpp>
 #include <loot/api.h>
 
 #include "gui/state/loot_state.h"
+#include "gui/state/query_arena.h"
 
 namespace loot {
 class DerivedPluginMetadata {
 public:
   DerivedPluginMetadata(LootState& state,
+                        const std::shared_ptr<const PluginInterface>& file,
+                        const PluginMetadata& evaluatedMetadata) :
+      DerivedPluginMetadata(*state.getCurrentGame().GetSnapshot(),
+                            state.getLanguage(),
+                            file,
+                            evaluatedMetadata) {}
+
+  DerivedPluginMetadata(const gui::GameSnapshot& snapshot,
+                        const std::string& language,
                         const std::shared_ptr<const PluginInterface>& file,
                         const PluginMetadata& evaluatedMetadata) {
     name = file->GetName();
     version = file->GetVersion();
-    isActive = state.getCurrentGame().IsPluginActive(name);
+    isActive = snapshot.IsPluginActive(name);
     isDirty = !evaluatedMetadata.GetDirtyInfo().empty();
     isEmpty = file->IsEmpty();
     isMaster = file->IsMaster();
@@ -46,18 +58,20 @@ public:
     loadsArchive = file->LoadsArchive();
 
     crc = file->GetCRC();
-    loadOrderIndex = state.getCurrentGame().GetActiveLoadOrderIndex(file,
-      state.getCurrentGame().GetLoadOrder());
+    loadOrderIndex = snapshot.GetActiveLoadOrderIndex(name);
 
     priority = evaluatedMetadata.GetLocalPriority().GetValue();
     globalPriority = evaluatedMetadata.GetGlobalPriority().GetValue();
     if (!evaluatedMetadata.GetCleanInfo().empty()) {
       cleanedWith = evaluatedMetadata.GetCleanInfo().begin()->GetCleaningUtility();
     }
-    messages = evaluatedMetadata.GetSimpleMessages(state.getLanguage());
-    tags = evaluatedMetadata.GetTags();
+    auto simpleMessages = evaluatedMetadata.GetSimpleMessages(language);
+    messages.assign(std::make_move_iterator(simpleMessages.begin()),
+                    std::make_move_iterator(simpleMessages.end()));
+    auto evaluatedTags = evaluatedMetadata.GetTags();
+    tags.insert(evaluatedTags.begin(), evaluatedTags.end());
 
-    language = state.getLanguage();
+    this->language = language;
   }
 
   void storeUnevaluatedMetadata(PluginMetadata masterlistEntry, PluginMetadata userlistEntry) {
@@ -84,8 +98,9 @@ private:
   short priority;
   short globalPriority;
   std::string cleanedWith;
-  std::vector<SimpleMessage> messages;
-  std::set<Tag> tags;
+  // Only needed until the query's response has been serialised.
+  std::vector<SimpleMessage, gui::ArenaAllocator<SimpleMessage>> messages;
+  std::set<Tag, std::less<Tag>, gui::ArenaAllocator<Tag>> tags;
 
   PluginMetadata masterlistMetadata;
   PluginMetadata userMetadata;
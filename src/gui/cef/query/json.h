@@ -28,10 +28,16 @@ along with LOOT.  If not, see
 #undef min
 #undef max
 
+#include <algorithm>
+
 #include <json.hpp>
 #include <loot/api.h>
 
 #include "gui/cef/query/derived_plugin_metadata.h"
+#include "gui/state/game_batch.h"
+#include "gui/state/load_order_moves.h"
+#include "gui/state/memory_usage.h"
+#include "gui/state/modlist_batch.h"
 
 namespace loot {
 void testConditionSyntax(const std::string& objectType,
@@ -370,6 +376,163 @@ void to_json(nlohmann::json& json, const DerivedPluginMetadata& plugin) {
     json["userlist"] = to_json_with_language(plugin.userMetadata, plugin.language);
   }
 }
+
+namespace gui {
+void to_json(nlohmann::json& json, const LoadOrderMove& move) {
+  json = {
+    { "name", move.name },
+    { "from", move.from },
+    { "to", move.to },
+  };
+}
+
+void from_json(const nlohmann::json& json, LoadOrderMove& move) {
+  move = LoadOrderMove{json.at("name"), json.at("from"), json.at("to")};
+}
+
+void to_json(nlohmann::json& json, const GameBatchResult& result) {
+  json = {
+    { "folder", result.folderName },
+    { "masterlistUpdated", result.isMasterlistUpdated },
+    { "sorted", result.isSorted },
+    { "loadOrderChanged", result.isLoadOrderChanged },
+    { "applied", result.isApplied },
+    { "sortedLoadOrder", result.sortedLoadOrder },
+    { "generalMessages", result.generalMessages },
+    { "plugins", nlohmann::json::array() },
+    { "valid", result.isValid },
+    { "durationMs", result.duration.count() },
+  };
+
+  for (const auto& plugin : result.pluginMessages) {
+    json["plugins"].push_back({
+      { "name", plugin.first },
+      { "messages", plugin.second },
+    });
+  }
+
+  if (!result.profilePath.empty()) {
+    json["profile"] = result.profilePath;
+  }
+
+  if (!result.error.empty()) {
+    json["error"] = result.error;
+  }
+}
+
+void to_json(nlohmann::json& json, const LoadOrderViolation& violation) {
+  std::string reason;
+  switch (violation.reason) {
+    case LoadOrderViolation::Reason::master:
+      reason = "master";
+      break;
+    case LoadOrderViolation::Reason::loadAfter:
+      reason = "loadAfter";
+      break;
+    case LoadOrderViolation::Reason::requirement:
+      reason = "requirement";
+      break;
+  }
+
+  json = {
+    { "plugin", violation.plugin },
+    { "otherPlugin", violation.otherPlugin },
+    { "reason", reason },
+  };
+}
+
+void to_json(nlohmann::json& json, const ModlistReport& report) {
+  json = {
+    { "name", report.name },
+    { "missingMasters", nlohmann::json::array() },
+    { "violations", report.violations },
+    { "sortErrors", report.sortErrors },
+    { "sortedLoadOrder", report.sortedLoadOrder },
+    { "loadOrderDifferences", nlohmann::json::array() },
+    { "valid", report.isValid },
+    { "durationMs", report.duration.count() },
+  };
+
+  for (const auto& missingMaster : report.missingMasters) {
+    json["missingMasters"].push_back({
+      { "plugin", missingMaster.plugin },
+      { "master", missingMaster.master },
+    });
+  }
+
+  for (const auto& difference : report.loadOrderDifferences) {
+    json["loadOrderDifferences"].push_back({
+      { "name", difference.plugin },
+      { "position", difference.position },
+      { "sortedPosition", difference.sortedPosition },
+    });
+  }
+
+  if (!report.error.empty()) {
+    json["error"] = report.error;
+  }
+}
+
+void to_json(nlohmann::json& json, const ModlistBatchResult& result) {
+  json = {
+    { "modlists", result.reports },
+    { "pluginFiles", result.pluginFileCount },
+    { "uniquePlugins", result.uniquePluginCount },
+    { "valid",
+      std::all_of(begin(result.reports),
+                  end(result.reports),
+                  [](const ModlistReport& report) { return report.isValid; }) },
+    { "durationMs", result.duration.count() },
+  };
+}
+
+void to_json(nlohmann::json& json, const GameMemoryUsage& usage) {
+  json = {
+    { "total", usage.Total() },
+    { "plugins", usage.plugins },
+    { "metadata", usage.metadata },
+    { "formIdIndex", usage.formIdIndex },
+    { "derivedData", usage.derivedData },
+    { "state", usage.state },
+  };
+}
+
+void to_json(nlohmann::json& json, const MemoryReport& report) {
+  json = {
+    { "games", nlohmann::json::array() },
+    { "counted", nlohmann::json::array() },
+    { "heap", nullptr },
+  };
+
+  for (const auto& game : report.games) {
+    nlohmann::json gameJson = {
+      { "name", game.name },
+      { "folder", game.folderName },
+      { "isCurrent", game.isCurrent },
+      { "bytes", game.usage },
+    };
+    if (!game.profilePath.empty()) {
+      gameJson["profile"] = game.profilePath;
+    }
+    json["games"].push_back(gameJson);
+  }
+
+  for (const auto& subsystem : report.subsystems) {
+    json["counted"].push_back({
+      { "name", subsystem.name },
+      { "bytes", subsystem.count.bytes },
+      { "allocations", subsystem.count.allocations },
+    });
+  }
+
+  if (report.heap.isAvailable) {
+    json["heap"] = {
+      { "allocated", report.heap.allocated },
+      { "reserved", report.heap.reserved },
+    };
+  }
+}
+}
 }
 
 #endif
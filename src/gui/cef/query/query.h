@@ -25,46 +25,122 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_QUERY
 #define LOOT_GUI_QUERY_QUERY
 
-#include <include/wrapper/cef_message_router.h>
+#include <chrono>
+#include <string>
+
 #include <boost/locale.hpp>
 
+#include "gui/state/event_sink.h"
 #include "gui/state/logging.h"
+#include "gui/state/memory_usage.h"
+#include "gui/state/performance_stats.h"
+#include "gui/state/query_arena.h"
 
 namespace loot {
-class Query : public CefBaseRefCounted {
+// Receives the outcome of executing a query, so that queries don't depend on
+// how their responses are delivered.
+class QueryCallback {
+public:
+  virtual ~QueryCallback() {}
+
+  virtual void Success(const std::string& response) = 0;
+  // The message is that of the exception that the query threw, which has
+  // already been logged.
+  virtual void Failure(const std::string& errorMessage) = 0;
+};
+
+class Query {
 public:
-  void execute(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) {
+  virtual ~Query() {}
+
+  void execute(QueryCallback& callback) {
+    gui::PhaseTimings timings;
+    gui::PhaseTimings::Scope timingsScope(timings);
+    auto start = std::chrono::steady_clock::now();
+    size_t responseSize = 0;
+
     try {
-      callback->Success(executeLogic());
+      auto response = executeLogicInArena();
+      gui::CountedMemoryScope responseMemory(
+          gui::MemorySubsystem::queryResponses, response.capacity());
+      flushEvents();
+      responseSize = response.size();
+      gui::PhaseTimer timer("sendResponse");
+      callback.Success(response);
     } catch (std::exception& e) {
       auto logger = getLogger();
       if (logger) {
         logger->error("Exception while executing query: {}", e.what());
       }
-      callback->Failure(-1,
-                        boost::locale::translate(
-                            "Oh no, something went wrong! You can check your "
-                            "LOOTDebugLog.txt (you can get to it through the "
-                            "main menu) for more information.")
-                            .str());
+      flushEvents();
+      callback.Failure(e.what());
+    }
+
+    if (performanceStats_ != nullptr) {
+      performanceStats_->Record(name_,
+                                std::chrono::steady_clock::now() - start,
+                                responseSize,
+                                timings);
     }
   }
 
+  // Record the time taken to execute the query under the given name.
+  void recordPerformance(const std::string& name,
+                         gui::PerformanceStats& performanceStats) {
+    name_ = name;
+    performanceStats_ = &performanceStats;
+  }
+
 protected:
+  Query() : performanceStats_(nullptr) {}
+  Query(std::shared_ptr<EventSink> events) :
+      events_(events),
+      performanceStats_(nullptr) {}
+
   virtual std::string executeLogic() = 0;
 
-  void sendProgressUpdate(CefRefPtr<CefFrame> frame,
-                          const std::string& message) {
+  void sendProgressUpdate(const std::string& phase,
+                          const std::string& message,
+                          size_t done = 0,
+                          size_t total = 0,
+                          const std::string& plugin = "") {
     auto logger = getLogger();
     if (logger) {
       logger->trace("Sending progress update: {}", message);
     }
-    frame->ExecuteJavaScript(
-        "loot.Dialog.showProgress('" + message + "');", frame->GetURL(), 0);
+    if (events_) {
+      events_->sendProgress(ProgressEvent(phase, message, done, total, plugin));
+    }
+  }
+
+  void sendInvalidation(const std::string& scope) {
+    if (events_) {
+      events_->sendInvalidation(scope);
+    }
   }
 
+  std::shared_ptr<EventSink> getEventSink() const { return events_; }
+
 private:
-  IMPLEMENT_REFCOUNTING(Query);
+  // The temporaries that the query allocates through ArenaAllocators are all
+  // freed when it completes, rather than one at a time as they go out of
+  // scope.
+  std::string executeLogicInArena() {
+    gui::QueryArena arena;
+    gui::QueryArena::Scope arenaScope(arena);
+
+    return executeLogic();
+  }
+
+  void flushEvents() {
+    if (events_) {
+      events_->flush();
+    }
+  }
+
+  std::shared_ptr<EventSink> events_;
+  std::string name_;
+  gui::PerformanceStats* performanceStats_;
 };
 }
 
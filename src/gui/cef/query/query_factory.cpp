@@ -0,0 +1,164 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_factory.h"
+
+#include "gui/cef/query/types/apply_sort_query.h"
+#include "gui/cef/query/types/cancel_sort_query.h"
+#include "gui/cef/query/types/change_game_query.h"
+#include "gui/cef/query/types/clear_all_metadata_query.h"
+#include "gui/cef/query/types/clear_plugin_metadata_query.h"
+#include "gui/cef/query/types/close_settings_query.h"
+#include "gui/cef/query/types/copy_content_query.h"
+#include "gui/cef/query/types/copy_load_order_query.h"
+#include "gui/cef/query/types/copy_metadata_query.h"
+#include "gui/cef/query/types/discard_unapplied_changes_query.h"
+#include "gui/cef/query/types/editor_closed_query.h"
+#include "gui/cef/query/types/editor_opened_query.h"
+#include "gui/cef/query/types/get_conflict_matrix_query.h"
+#include "gui/cef/query/types/get_conflicting_plugins_query.h"
+#include "gui/cef/query/types/get_game_data_query.h"
+#include "gui/cef/query/types/get_game_types_query.h"
+#include "gui/cef/query/types/get_init_errors_query.h"
+#include "gui/cef/query/types/get_installed_games_query.h"
+#include "gui/cef/query/types/get_languages_query.h"
+#include "gui/cef/query/types/get_memory_usage_query.h"
+#include "gui/cef/query/types/get_performance_stats_query.h"
+#include "gui/cef/query/types/get_settings_query.h"
+#include "gui/cef/query/types/get_version_query.h"
+#include "gui/cef/query/types/open_log_location_query.h"
+#include "gui/cef/query/types/open_readme_query.h"
+#include "gui/cef/query/types/redate_plugins_query.h"
+#include "gui/cef/query/types/run_game_batch_query.h"
+#include "gui/cef/query/types/save_filter_state_query.h"
+#include "gui/cef/query/types/sort_plugins_query.h"
+#include "gui/cef/query/types/update_masterlist_query.h"
+#include "gui/cef/query/types/validate_load_order_query.h"
+#include "gui/cef/query/types/validate_modlists_query.h"
+
+namespace loot {
+std::unique_ptr<Query> createQuery(LootState& state,
+                                   std::shared_ptr<EventSink> events,
+                                   const nlohmann::json& request) {
+  const std::string name = request.at("name");
+
+  if (name == "applySort" && request.count("moves") != 0)
+    return std::make_unique<ApplySortQuery>(
+        state,
+        request.at("moves").get<std::vector<gui::LoadOrderMove>>());
+  else if (name == "applySort")
+    return std::make_unique<ApplySortQuery>(
+        state,
+        request.at("pluginNames")
+            .at("plugins")
+            .get<std::vector<std::string>>());
+  else if (name == "cancelSort")
+    return std::make_unique<CancelSortQuery>(state);
+  else if (name == "changeGame")
+    return std::make_unique<ChangeGameQuery>(
+        state,
+        events,
+        request.at("targetName"),
+        request.value("versions", nlohmann::json::object()));
+  else if (name == "clearAllMetadata")
+    return std::make_unique<ClearAllMetadataQuery>(state);
+  else if (name == "clearPluginMetadata")
+    return std::make_unique<ClearPluginMetadataQuery>(state,
+                                                      request.at("targetName"));
+  else if (name == "closeSettings")
+    return std::make_unique<CloseSettingsQuery>(state, request.at("settings"));
+  else if (name == "copyContent")
+    return std::make_unique<CopyContentQuery>(request.at("content"));
+  else if (name == "copyLoadOrder")
+    return std::make_unique<CopyLoadOrderQuery>(
+        state, request.at("pluginNames").at("plugins"));
+  else if (name == "copyMetadata")
+    return std::make_unique<CopyMetadataQuery>(state, request.at("targetName"));
+  else if (name == "discardUnappliedChanges")
+    return std::make_unique<DiscardUnappliedChangesQuery>(state);
+  else if (name == "editorClosed")
+    return std::make_unique<EditorClosedQuery>(state,
+                                               request.at("editorState"));
+  else if (name == "editorOpened")
+    return std::make_unique<EditorOpenedQuery>(state);
+  else if (name == "getConflictMatrix")
+    return std::make_unique<GetConflictMatrixQuery>(state, events);
+  else if (name == "getConflictingPlugins")
+    return std::make_unique<GetConflictingPluginsQuery>(
+        state,
+        request.at("targetName"),
+        request.value("versions", nlohmann::json::object()));
+  else if (name == "getGameTypes")
+    return std::make_unique<GetGameTypesQuery>();
+  else if (name == "getGameData")
+    return std::make_unique<GetGameDataQuery>(
+        state, events, request.value("versions", nlohmann::json::object()));
+  else if (name == "getInitErrors")
+    return std::make_unique<GetInitErrorsQuery>(state);
+  else if (name == "getInstalledGames")
+    return std::make_unique<GetInstalledGamesQuery>(state);
+  else if (name == "getLanguages")
+    return std::make_unique<GetLanguagesQuery>();
+  else if (name == "getMemoryUsage")
+    return std::make_unique<GetMemoryUsageQuery>(state);
+  else if (name == "getPerformanceStats")
+    return std::make_unique<GetPerformanceStatsQuery>(state);
+  else if (name == "getSettings")
+    return std::make_unique<GetSettingsQuery>(state);
+  else if (name == "getVersion")
+    return std::make_unique<GetVersionQuery>();
+  else if (name == "openLogLocation")
+    return std::make_unique<OpenLogLocationQuery>();
+  else if (name == "openReadme")
+    return std::make_unique<OpenReadmeQuery>();
+  else if (name == "redatePlugins")
+    return std::make_unique<RedatePluginsQuery>(state);
+  else if (name == "runGameBatch")
+    return std::make_unique<RunGameBatchQuery>(
+        state,
+        request.value("games", std::vector<std::string>()),
+        request.value("profiles", std::vector<std::string>()),
+        request.value("apply", false));
+  else if (name == "saveFilterState")
+    return std::make_unique<SaveFilterStateQuery>(
+        state,
+        request.at("filter").at("name"),
+        request.at("filter").at("state"));
+  else if (name == "sortPlugins")
+    return std::make_unique<SortPluginsQuery>(
+        state, events, request.value("versions", nlohmann::json::object()));
+  else if (name == "updateMasterlist")
+    return std::make_unique<UpdateMasterlistQuery>(state);
+  else if (name == "validateLoadOrder")
+    return std::make_unique<ValidateLoadOrderQuery>(state);
+  else if (name == "validateModlists")
+    return std::make_unique<ValidateModlistsQuery>(
+        state,
+        request.at("manifests").get<std::vector<std::string>>(),
+        request.value("workPath", std::string()),
+        request.value("threads", 0u));
+
+  return nullptr;
+}
+}
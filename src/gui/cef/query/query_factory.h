@@ -0,0 +1,45 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_FACTORY
+#define LOOT_GUI_QUERY_QUERY_FACTORY
+
+#include <memory>
+
+#include "gui/cef/query/query.h"
+#include "gui/state/event_sink.h"
+#include "gui/state/loot_state.h"
+
+#undef min
+#include <json.hpp>
+
+namespace loot {
+// Creates the query named by the request, for any query that doesn't need a
+// browser to run. Returns nullptr if the request names no such query.
+std::unique_ptr<Query> createQuery(LootState& state,
+                                   std::shared_ptr<EventSink> events,
+                                   const nlohmann::json& request);
+}
+
+#endif
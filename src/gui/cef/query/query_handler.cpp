@@ -25,53 +25,62 @@
 #include "gui/cef/query/query_handler.h"
 
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
 
 #include <boost/filesystem.hpp>
-#include <include/base/cef_bind.h>
 #include <include/cef_app.h>
 #include <include/cef_task.h>
-#include <include/wrapper/cef_closure_task.h>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
 #include "gui/cef/loot_app.h"
 #include "gui/cef/loot_handler.h"
-#include "gui/cef/query/types/apply_sort_query.h"
+#include "gui/cef/query/query_factory.h"
 #include "gui/cef/query/types/cancel_find_query.h"
-#include "gui/cef/query/types/cancel_sort_query.h"
-#include "gui/cef/query/types/change_game_query.h"
-#include "gui/cef/query/types/clear_all_metadata_query.h"
-#include "gui/cef/query/types/clear_plugin_metadata_query.h"
-#include "gui/cef/query/types/close_settings_query.h"
-#include "gui/cef/query/types/copy_content_query.h"
-#include "gui/cef/query/types/copy_load_order_query.h"
-#include "gui/cef/query/types/copy_metadata_query.h"
-#include "gui/cef/query/types/discard_unapplied_changes_query.h"
-#include "gui/cef/query/types/editor_closed_query.h"
-#include "gui/cef/query/types/editor_opened_query.h"
-#include "gui/cef/query/types/get_conflicting_plugins_query.h"
-#include "gui/cef/query/types/get_game_data_query.h"
-#include "gui/cef/query/types/get_game_types_query.h"
-#include "gui/cef/query/types/get_init_errors_query.h"
-#include "gui/cef/query/types/get_installed_games_query.h"
-#include "gui/cef/query/types/get_languages_query.h"
-#include "gui/cef/query/types/get_settings_query.h"
-#include "gui/cef/query/types/get_version_query.h"
-#include "gui/cef/query/types/open_log_location_query.h"
-#include "gui/cef/query/types/open_readme_query.h"
-#include "gui/cef/query/types/redate_plugins_query.h"
-#include "gui/cef/query/types/save_filter_state_query.h"
-#include "gui/cef/query/types/sort_plugins_query.h"
-#include "gui/cef/query/types/update_masterlist_query.h"
 
 #undef min
 #include <json.hpp>
 
 namespace loot {
-QueryHandler::QueryHandler(LootState& lootState) : lootState_(lootState) {}
+namespace {
+// Executes a query on the thread it's posted to, and passes the outcome on to
+// the UI.
+class QueryTask : public CefTask, public QueryCallback {
+public:
+  QueryTask(std::unique_ptr<Query> query,
+            CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) :
+      query_(std::move(query)),
+      callback_(callback) {}
+
+  void Execute() OVERRIDE { query_->execute(*this); }
+
+  void Success(const std::string& response) { callback_->Success(response); }
+
+  // The details have already been logged, so just point the user there.
+  void Failure(const std::string& error) {
+    callback_->Failure(-1,
+                       boost::locale::translate(
+                           "Oh no, something went wrong! You can check your "
+                           "LOOTDebugLog.txt (you can get to it through the "
+                           "main menu) for more information.")
+                           .str());
+  }
+
+private:
+  std::unique_ptr<Query> query_;
+  CefRefPtr<CefMessageRouterBrowserSide::Callback> callback_;
+
+  IMPLEMENT_REFCOUNTING(QueryTask);
+};
+}
+
+QueryHandler::QueryHandler(LootState& lootState,
+                           std::shared_ptr<EventChannel> events) :
+    lootState_(lootState),
+    events_(events) {}
 
 // Called due to cefQuery execution in binding.html.
 bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
@@ -81,12 +90,37 @@ bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
                            bool persistent,
                            CefRefPtr<Callback> callback) {
   try {
+    if (persistent) {
+      // The only persistent query is the UI's subscription to backend events.
+      nlohmann::json json = nlohmann::json::parse(request.ToString());
+      if (json.at("name") != "subscribe")
+        return false;
+
+      events_->subscribe(query_id, callback);
+      return true;
+    }
+
+    const std::string name =
+        nlohmann::json::parse(request.ToString()).at("name");
+
+    // Queries run one at a time on the file thread, so a cancellation has to
+    // be handled here or it would wait for the query it is meant to cancel.
+    if (name == "cancelConflictMatrix") {
+      lootState_.cancelConflictMatrix();
+      callback->Success("");
+      return true;
+    }
+
     auto query = createQuery(browser, frame, request.ToString());
 
     if (!query)
       return false;
 
-    CefPostTask(TID_FILE, base::Bind(&Query::execute, query, callback));
+    // Don't let asking for the stats push out the stats being asked for.
+    if (name != "getPerformanceStats")
+      query->recordPerformance(name, lootState_.getPerformanceStats());
+
+    CefPostTask(TID_FILE, new QueryTask(std::move(query), callback));
   } catch (std::exception& e) {
     auto logger = lootState_.getLogger();
     if (logger) {
@@ -100,69 +134,21 @@ bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
   return true;
 }
 
-CefRefPtr<Query> QueryHandler::createQuery(CefRefPtr<CefBrowser> browser,
-                                           CefRefPtr<CefFrame> frame,
-                                           const std::string& requestString) {
+void QueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                                   CefRefPtr<CefFrame> frame,
+                                   int64 query_id) {
+  events_->unsubscribe(query_id);
+}
+
+std::unique_ptr<Query> QueryHandler::createQuery(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    const std::string& requestString) {
   nlohmann::json json = nlohmann::json::parse(requestString);
 
-  const std::string name = json.at("name");
-
-  if (name == "applySort")
-    return new ApplySortQuery(lootState_, json.at("pluginNames").at("plugins"));
-  else if (name == "cancelFind")
-    return new CancelFindQuery(browser);
-  else if (name == "cancelSort")
-    return new CancelSortQuery(lootState_);
-  else if (name == "changeGame")
-    return new ChangeGameQuery(lootState_, frame, json.at("targetName"));
-  else if (name == "clearAllMetadata")
-    return new ClearAllMetadataQuery(lootState_);
-  else if (name == "clearPluginMetadata")
-    return new ClearPluginMetadataQuery(lootState_, json.at("targetName"));
-  else if (name == "closeSettings")
-    return new CloseSettingsQuery(lootState_, json.at("settings"));
-  else if (name == "copyContent")
-    return new CopyContentQuery(json.at("content"));
-  else if (name == "copyLoadOrder")
-    return new CopyLoadOrderQuery(lootState_, json.at("pluginNames").at("plugins"));
-  else if (name == "copyMetadata")
-    return new CopyMetadataQuery(lootState_, json.at("targetName"));
-  else if (name == "discardUnappliedChanges")
-    return new DiscardUnappliedChangesQuery(lootState_);
-  else if (name == "editorClosed")
-    return new EditorClosedQuery(lootState_, json.at("editorState"));
-  else if (name == "editorOpened")
-    return new EditorOpenedQuery(lootState_);
-  else if (name == "getConflictingPlugins")
-    return new GetConflictingPluginsQuery(lootState_, json.at("targetName"));
-  else if (name == "getGameTypes")
-    return new GetGameTypesQuery();
-  else if (name == "getGameData")
-    return new GetGameDataQuery(lootState_, frame);
-  else if (name == "getInitErrors")
-    return new GetInitErrorsQuery(lootState_);
-  else if (name == "getInstalledGames")
-    return new GetInstalledGamesQuery(lootState_);
-  else if (name == "getLanguages")
-    return new GetLanguagesQuery();
-  else if (name == "getSettings")
-    return new GetSettingsQuery(lootState_);
-  else if (name == "getVersion")
-    return new GetVersionQuery();
-  else if (name == "openLogLocation")
-    return new OpenLogLocationQuery();
-  else if (name == "openReadme")
-    return new OpenReadmeQuery();
-  else if (name == "redatePlugins")
-    return new RedatePluginsQuery(lootState_);
-  else if (name == "saveFilterState")
-    return new SaveFilterStateQuery(
-        lootState_, json.at("filter").at("name"), json.at("filter").at("state"));
-  else if (name == "sortPlugins")
-    return new SortPluginsQuery(lootState_, frame);
-  else if (name == "updateMasterlist")
-    return new UpdateMasterlistQuery(lootState_);
-
-  return nullptr;
+  if (json.at("name") == "cancelFind")
+    return std::make_unique<CancelFindQuery>(browser);
+
+  return loot::createQuery(lootState_, events_, json);
 }
 }
@@ -25,15 +25,18 @@
 #ifndef LOOT_GUI_QUERY_HANDLER
 #define LOOT_GUI_QUERY_HANDLER
 
+#include <memory>
+
 #include <include/wrapper/cef_message_router.h>
 
+#include "gui/cef/event_channel.h"
 #include "gui/cef/query/query.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
 class QueryHandler : public CefMessageRouterBrowserSide::Handler {
 public:
-  QueryHandler(LootState& lootState);
+  QueryHandler(LootState& lootState, std::shared_ptr<EventChannel> events);
 
   // Called due to cefQuery execution in binding.html.
   virtual bool OnQuery(CefRefPtr<CefBrowser> browser,
@@ -43,12 +46,17 @@ public:
                        bool persistent,
                        CefRefPtr<Callback> callback) OVERRIDE;
 
-private:
-  CefRefPtr<Query> createQuery(CefRefPtr<CefBrowser> browser,
+  virtual void OnQueryCanceled(CefRefPtr<CefBrowser> browser,
                                CefRefPtr<CefFrame> frame,
-                               const std::string& request);
+                               int64 query_id) OVERRIDE;
+
+private:
+  std::unique_ptr<Query> createQuery(CefRefPtr<CefBrowser> browser,
+                                     CefRefPtr<CefFrame> frame,
+                                     const std::string& request);
 
   LootState& lootState_;
+  std::shared_ptr<EventChannel> events_;
 };
 }
 
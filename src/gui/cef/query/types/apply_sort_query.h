@@ -26,21 +26,45 @@ along with LOOT.  If not, see
 #define LOOT_GUI_QUERY_APPLY_SORT_QUERY
 
 #include "gui/cef/query/query.h"
+#include "gui/state/load_order_moves.h"
 
 namespace loot {
 class ApplySortQuery : public Query {
 public:
   ApplySortQuery(LootState& state, const std::vector<std::string>& plugins) :
       state_(state),
-      plugins_(plugins) {}
+      plugins_(plugins),
+      useMoves_(false) {}
+
+  // The moves are made to the current load order of the loaded plugins, as
+  // given by the sortPlugins query.
+  ApplySortQuery(LootState& state,
+                 const std::vector<gui::LoadOrderMove>& moves) :
+      state_(state),
+      moves_(moves),
+      useMoves_(true) {}
 
   std::string executeLogic() {
     auto logger = state_.getLogger();
     if (logger) {
       logger->trace("User has accepted sorted load order, applying it.");
     }
+
+    auto plugins = plugins_;
+    if (useMoves_) {
+      auto snapshot = state_.getCurrentGame().GetSnapshot();
+      std::vector<std::string> loadOrder;
+      for (const auto& pluginName : snapshot->GetLoadOrder()) {
+        auto facts = snapshot->GetPluginFacts(pluginName);
+        if (facts != nullptr)
+          loadOrder.push_back(facts->name);
+      }
+
+      plugins = gui::applyLoadOrderMoves(loadOrder, moves_);
+    }
+
     state_.decrementUnappliedChangeCounter();
-    state_.getCurrentGame().SetLoadOrder(plugins_);
+    state_.getCurrentGame().SetLoadOrder(plugins);
 
     return "";
   }
@@ -48,6 +72,8 @@ public:
 private:
   LootState& state_;
   const std::vector<std::string> plugins_;
+  const std::vector<gui::LoadOrderMove> moves_;
+  const bool useMoves_;
 };
 }
 
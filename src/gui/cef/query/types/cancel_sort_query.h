@@ -43,19 +43,15 @@ public:
       { "generalMessages", getGeneralMessages() },
     };
 
-    std::vector<std::string> loadOrder = state_.getCurrentGame().GetLoadOrder();
-    for (const auto& plugin : loadOrder) {
-      auto pluginObject = state_.getCurrentGame().GetPlugin(plugin);
-      auto loadOrderIndex = state_.getCurrentGame().GetActiveLoadOrderIndex(
-          pluginObject, loadOrder);
-
+    auto snapshot = state_.getCurrentGame().GetSnapshot();
+    for (const auto& plugin : snapshot->GetLoadOrder()) {
       json["plugins"].push_back({
         { "name", plugin },
-        { "loadOrderIndex", loadOrderIndex },
+        { "loadOrderIndex", snapshot->GetActiveLoadOrderIndex(plugin) },
       });
     }
 
-    return json.dump();
+    return serialise(json);
   }
 
 private:
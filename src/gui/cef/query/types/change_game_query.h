@@ -31,11 +31,14 @@ namespace loot {
 class ChangeGameQuery : public GetGameDataQuery {
 public:
   ChangeGameQuery(LootState& state,
-                  CefRefPtr<CefFrame> frame,
-                  const std::string& gameFolder) :
-      GetGameDataQuery(state, frame),
+                  std::shared_ptr<EventSink> events,
+                  const std::string& gameFolder,
+                  const nlohmann::json& clientVersions) :
+      GetGameDataQuery(state, events, clientVersions),
       state_(state),
-      gameFolder_(gameFolder) {}
+      gameFolder_(gameFolder) {
+    reuseLoadedState();
+  }
 
   std::string executeLogic() {
     state_.changeGame(gameFolder_);
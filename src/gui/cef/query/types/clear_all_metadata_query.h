@@ -78,7 +78,7 @@ private:
       json["plugins"].push_back(generateDerivedMetadata(pluginName));
     }
 
-    return json.dump();
+    return serialise(json);
   }
 
   gui::Game& game_;
@@ -41,10 +41,12 @@ public:
       plugins_(plugins) {}
 
   std::string executeLogic() {
+    auto snapshot = state_.getCurrentGame().GetSnapshot();
+
     Counters counters;
     std::stringstream stream;
     for (const auto& pluginName : plugins_) {
-      writePluginLine(stream, pluginName, counters);
+      writePluginLine(stream, *snapshot, pluginName, counters);
     }
 
     copyToClipboard(stream.str());
@@ -53,11 +55,12 @@ public:
 
 private:
   void writePluginLine(std::ostream& stream,
+                       const gui::GameSnapshot& snapshot,
                        const std::string& plugin,
                        Counters& counters) {
-    auto isActive = state_.getCurrentGame().IsPluginActive(plugin);
-    auto isLightMaster =
-        state_.getCurrentGame().GetPlugin(plugin)->IsLightMaster();
+    auto facts = snapshot.GetPluginFacts(plugin);
+    auto isActive = facts != nullptr && facts->isActive;
+    auto isLightMaster = facts != nullptr && facts->isLightMaster;
 
     if (isActive && isLightMaster) {
       stream << "254 FE " << std::setw(3) << std::hex
@@ -0,0 +1,120 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_GUI_QUERY_GET_CONFLICT_MATRIX_QUERY
+#define LOOT_GUI_QUERY_GET_CONFLICT_MATRIX_QUERY
+
+#include <numeric>
+
+#include "gui/cef/query/json.h"
+#include "gui/cef/query/query.h"
+#include "gui/state/loot_state.h"
+
+namespace loot {
+class GetConflictMatrixQuery : public Query {
+public:
+  GetConflictMatrixQuery(LootState& state, std::shared_ptr<EventSink> events) :
+      Query(events),
+      state_(state) {}
+
+  std::string executeLogic() {
+    auto cancelled = state_.startConflictMatrix();
+    gui::Game& game = state_.getCurrentGame();
+
+    const std::string message =
+        boost::locale::translate("Finding conflicts between all plugins...")
+            .str();
+    sendProgressUpdate("conflictMatrix", message);
+    game.UpdateFormIdIndex(cancelled.get());
+
+    auto matrix = game.GetFormIdIndex()->GetConflictMatrix(
+        [&](size_t done, size_t total) {
+          sendProgressUpdate("conflictMatrix", message, done, total);
+        },
+        cancelled.get());
+
+    if (*cancelled) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->debug("Conflict matrix cancelled.");
+      }
+      return nlohmann::json({ { "cancelled", true } }).dump();
+    }
+
+    return getJsonResponse(matrix);
+  }
+
+private:
+  /* Plugins are listed in descending order of how many other plugins they
+     conflict with, then how many FormIDs they share with them. Each plugin's
+     conflicts are given as [index, overlapping FormID count] pairs, where
+     the index is into the plugins array. */
+  static std::string getJsonResponse(
+      const gui::FormIdIndex::ConflictMatrix& matrix) {
+    std::vector<uint32_t> overlapCounts(matrix.plugins.size());
+    for (size_t i = 0; i < matrix.plugins.size(); ++i) {
+      for (const auto& conflict : matrix.conflicts[i]) {
+        overlapCounts[i] += conflict.second;
+      }
+    }
+
+    std::vector<size_t> ranking(matrix.plugins.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(
+        ranking.begin(), ranking.end(), [&](size_t lhs, size_t rhs) {
+          auto lhsCount = matrix.conflicts[lhs].size();
+          auto rhsCount = matrix.conflicts[rhs].size();
+          return lhsCount > rhsCount ||
+                 (lhsCount == rhsCount &&
+                  overlapCounts[lhs] > overlapCounts[rhs]);
+        });
+
+    std::vector<size_t> positions(ranking.size());
+    for (size_t i = 0; i < ranking.size(); ++i) {
+      positions[ranking[i]] = i;
+    }
+
+    nlohmann::json json = { { "plugins", nlohmann::json::array() } };
+    for (const auto index : ranking) {
+      nlohmann::json conflicts = nlohmann::json::array();
+      for (const auto& conflict : matrix.conflicts[index]) {
+        conflicts.push_back({ positions[conflict.first], conflict.second });
+      }
+
+      json["plugins"].push_back({
+        { "name", matrix.plugins[index] },
+        { "conflictCount", matrix.conflicts[index].size() },
+        { "overlapCount", overlapCounts[index] },
+        { "conflicts", conflicts },
+      });
+    }
+
+    return json.dump();
+  }
+
+  LootState& state_;
+};
+}
+
+#endif
@@ -25,6 +25,10 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_GET_CONFLICTING_PLUGINS_QUERY
 #define LOOT_GUI_QUERY_GET_CONFLICTING_PLUGINS_QUERY
 
+#include <unordered_set>
+
+#include <boost/algorithm/string.hpp>
+
 #include "gui/cef/query/json.h"
 #include "gui/cef/query/types/metadata_query.h"
 #include "gui/state/game.h"
@@ -32,10 +36,19 @@ along with LOOT.  If not, see
 namespace loot {
 class GetConflictingPluginsQuery : public MetadataQuery {
 public:
-  GetConflictingPluginsQuery(LootState& state, const std::string& pluginName) :
+  /* If clientVersions holds the "derivedPlugins" version that the client's
+     plugin data was derived at, the response only lists the names of the
+     conflicting plugins and the derived metadata of plugins that has changed
+     since. Otherwise every plugin's derived metadata is given along with
+     whether it conflicts. */
+  GetConflictingPluginsQuery(LootState& state,
+                             const std::string& pluginName,
+                             const nlohmann::json& clientVersions =
+                                 nlohmann::json::object()) :
       MetadataQuery(state),
-      game_(state.getCurrentGame()),
-      pluginName_(pluginName) {}
+      state_(state),
+      pluginName_(pluginName),
+      clientVersions_(clientVersions) {}
 
   std::string executeLogic() {
     logger_ = getLogger();
@@ -43,46 +56,87 @@ public:
       logger_->debug("Searching for plugins that conflict with {}", pluginName_);
     }
 
-    // Checking for FormID overlap will only work if the plugins have been
-    // loaded, so check if the plugins have been fully loaded, and if not load
-    // all plugins.
-    if (!game_.ArePluginsFullyLoaded())
-      game_.LoadAllInstalledPlugins(false);
+    // Conflicts are found through the FormID index, which reads plugin files
+    // itself, so the plugins don't need to be fully loaded and their derived
+    // metadata comes from their headers. The index is normally built in the
+    // background, or reused from the last session, so this usually only has
+    // to check that the installed plugins haven't changed.
+    gui::Game& game = state_.getCurrentGame();
+    game.UpdateFormIdIndex();
 
-    return getJsonResponse();
+    auto clientVersion = clientVersions_.find("derivedPlugins");
+    if (clientVersion != clientVersions_.end() && clientVersion->is_string())
+      return getSlimJsonResponse(game, *clientVersion);
+
+    return getJsonResponse(game);
   }
 
 private:
-  std::string getJsonResponse() {
+  std::unordered_set<std::string> getConflicts(const gui::Game& game) {
+    // A plugin's records overlap with themselves, if it has any.
+    std::unordered_set<std::string> conflicts;
+    if (game.GetFormIdIndex()->GetFormIdCount(pluginName_) != 0)
+      conflicts.insert(boost::to_lower_copy(pluginName_));
+
+    for (const auto& name :
+         game.GetFormIdIndex()->GetOverlappingPlugins(pluginName_)) {
+      if (logger_) {
+        logger_->debug("Found conflicting plugin: {}", name);
+      }
+      conflicts.insert(boost::to_lower_copy(name));
+    }
+
+    return conflicts;
+  }
+
+  std::string getJsonResponse(const gui::Game& game) {
     nlohmann::json json;
 
+    auto conflicts = getConflicts(game);
+
     json["plugins"] = nlohmann::json::array();
-    auto plugin = game_.GetPlugin(pluginName_);
-    for (const auto& otherPlugin : game_.GetPlugins()) {
+    for (const auto& otherPlugin : game.GetPlugins()) {
       json["plugins"].push_back({
         { "metadata", generateDerivedMetadata(otherPlugin) },
-        { "conflicts", doPluginsConflict(plugin, otherPlugin) },
+        { "conflicts",
+          conflicts.count(boost::to_lower_copy(otherPlugin->GetName())) != 0 },
       });
     }
 
-    return json.dump();
+    return serialise(json);
   }
 
-  bool doPluginsConflict(
-      const std::shared_ptr<const PluginInterface>& plugin,
-      const std::shared_ptr<const PluginInterface>& otherPlugin) {
-    if (plugin->DoFormIDsOverlap(*otherPlugin)) {
-      if (logger_) {
-        logger_->debug("Found conflicting plugin: {}", otherPlugin->GetName());
-      }
-      return true;
-    } else {
-      return false;
+  std::string getSlimJsonResponse(gui::Game& game,
+                                  const std::string& clientVersion) {
+    auto snapshot = game.GetSnapshot();
+    const std::string version = getDerivedCacheKey(*snapshot);
+
+    nlohmann::json json = {
+      { "conflicts", nlohmann::json::array() },
+      { "plugins", nlohmann::json::array() },
+      { "versions", { { "derivedPlugins", version } } },
+    };
+
+    // Give names as the plugins were loaded, so they match the client's.
+    for (const auto& name : getConflicts(game)) {
+      auto facts = snapshot->GetPluginFacts(name);
+      json["conflicts"].push_back(facts == nullptr ? name : facts->name);
     }
+
+    if (clientVersion == version)
+      return serialise(json);
+
+    // The game caches the plugin data last sent to a client, so if that's
+    // what this client holds only the plugins that differ from it need to be
+    // sent.
+    json["plugins"] = generateChangedDerivedMetadata(*snapshot, clientVersion);
+
+    return serialise(json);
   }
 
-  gui::Game& game_;
+  LootState& state_;
   const std::string pluginName_;
+  const nlohmann::json clientVersions_;
   std::shared_ptr<spdlog::logger> logger_;
 };
 }
@@ -25,6 +25,9 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_GET_GAME_DATA_QUERY
 #define LOOT_GUI_QUERY_GET_GAME_DATA_QUERY
 
+#include <future>
+
+#include <boost/format.hpp>
 #include <boost/locale.hpp>
 
 #include "gui/cef/query/types/metadata_query.h"
@@ -34,42 +37,111 @@ along with LOOT.  If not, see
 namespace loot {
 class GetGameDataQuery : public MetadataQuery {
 public:
-  GetGameDataQuery(LootState& state, CefRefPtr<CefFrame> frame) :
-      MetadataQuery(state),
+  GetGameDataQuery(LootState& state,
+                   std::shared_ptr<EventSink> events,
+                   const nlohmann::json& clientVersions) :
+      MetadataQuery(state, events),
       state_(state),
-      frame_(frame) {}
+      clientVersions_(clientVersions),
+      reuseLoadedState_(false) {}
 
   std::string executeLogic() {
-    sendProgressUpdate(frame_,
+    sendProgressUpdate("loadPlugins",
                        boost::locale::translate(
                            "Parsing, merging and evaluating metadata..."));
 
     /* If the game's plugins object is empty, this is the first time loading
-       the game data, so also load the metadata lists. */
+       the game data, so also load the metadata lists. If masterlist updating
+       is enabled, fetch the update while the plugins load, so that the
+       metadata lists are only parsed once and metadata is only derived once,
+       after both have finished. */
     bool isFirstLoad = state_.getCurrentGame().GetPlugins().empty();
 
-    state_.getCurrentGame().LoadAllInstalledPlugins(true);
+    /* A game that was kept loaded after switching away from it can be used
+       as it is if nothing has been installed, removed or reordered since. */
+    bool isLoadedStateCurrent = !isFirstLoad && reuseLoadedState_ &&
+                                state_.getCurrentGame().IsLoadedStateCurrent();
+    if (isLoadedStateCurrent) {
+      auto logger = state_.getLogger();
+      if (logger) {
+        logger->debug("Reusing the loaded plugins and metadata for {}.",
+                      state_.getCurrentGame().Name());
+      }
+    }
+
+    std::future<gui::MasterlistUpdate> masterlistUpdate;
+    if (isFirstLoad && state_.updateMasterlist()) {
+      gui::Game& game = state_.getCurrentGame();
+      masterlistUpdate = std::async(std::launch::async, [&game]() {
+        return game.UpdateMasterlistFile();
+      });
+    }
 
-    if (isFirstLoad)
+    if (!isLoadedStateCurrent)
+      state_.getCurrentGame().LoadAllInstalledPlugins(true);
+
+    if (masterlistUpdate.valid())
+      waitForMasterlistUpdate(masterlistUpdate);
+
+    if (isFirstLoad) {
       state_.getCurrentGame().LoadMetadata();
 
-    // Sort plugins into their load order.
-    std::vector<std::shared_ptr<const PluginInterface>> installed;
-    std::vector<std::string> loadOrder = state_.getCurrentGame().GetLoadOrder();
-    for (const auto& pluginName : loadOrder) {
-      try {
-        const auto plugin = state_.getCurrentGame().GetPlugin(pluginName);
-        installed.push_back(plugin);
-      } catch (...) {
+      auto logger = state_.getLogger();
+      if (logger && state_.getCurrentGame().IsLoadOrderSorted()) {
+        logger->info("The current load order is already sorted.");
       }
     }
 
-    return generateJsonResponse(installed.cbegin(), installed.cend());
+    // Sort plugins into their load order.
+    auto snapshot = state_.getCurrentGame().GetSnapshot();
+    auto installed = getPluginsInLoadOrder(*snapshot);
+
+    auto response = generateJsonResponse(installed.cbegin(),
+                                         installed.cend(),
+                                         clientVersions_,
+                                         getDerivedCacheKey(*snapshot));
+
+    // Get the full plugin data that conflict checks need ready while the
+    // user is busy with the UI.
+    state_.loadPluginsInBackground(getEventSink());
+
+    return response;
   }
 
+protected:
+  // Set when changing game, as the game being changed to may still be loaded.
+  void reuseLoadedState() { reuseLoadedState_ = true; }
+
 private:
+  // The update only touches its own game handle, so it is recorded here,
+  // once the plugins have finished loading.
+  void waitForMasterlistUpdate(
+      std::future<gui::MasterlistUpdate>& masterlistUpdate) {
+    auto logger = state_.getLogger();
+    try {
+      auto update = masterlistUpdate.get();
+      state_.getCurrentGame().RecordMasterlistUpdate(update);
+      if (update.isUpdated && logger) {
+        logger->info("Masterlist updated while loading plugins.");
+      }
+    } catch (std::exception& e) {
+      // A failed update shouldn't stop the game data from loading, as the
+      // existing masterlist can still be used.
+      if (logger) {
+        logger->error("Masterlist update failed. Details: {}", e.what());
+      }
+      state_.getCurrentGame().AppendMessage(Message(
+          MessageType::error,
+          (boost::format(boost::locale::translate(
+               "The masterlist could not be updated. Details: %1%")) %
+           e.what())
+              .str()));
+    }
+  }
+
   LootState& state_;
-  CefRefPtr<CefFrame> frame_;
+  const nlohmann::json clientVersions_;
+  bool reuseLoadedState_;
 };
 }
 
@@ -0,0 +1,87 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_GUI_QUERY_GET_PERFORMANCE_STATS_QUERY
+#define LOOT_GUI_QUERY_GET_PERFORMANCE_STATS_QUERY
+
+#undef min
+
+#include <json.hpp>
+
+#include "gui/cef/query/query.h"
+#include "gui/state/loot_state.h"
+
+namespace loot {
+class GetPerformanceStatsQuery : public Query {
+public:
+  GetPerformanceStatsQuery(LootState& state) : state_(state) {}
+
+  std::string executeLogic() {
+    const auto& stats = state_.getPerformanceStats();
+
+    nlohmann::json json = {
+      { "recent", nlohmann::json::array() },
+      { "totals", nlohmann::json::array() },
+    };
+
+    for (const auto& execution : stats.GetRecentExecutions()) {
+      nlohmann::json phases = nlohmann::json::array();
+      for (const auto& phase : execution.phases) {
+        phases.push_back({
+          { "name", phase.name },
+          { "durationMs", toMilliseconds(phase.duration) },
+          { "count", phase.count },
+        });
+      }
+
+      json["recent"].push_back({
+        { "name", execution.name },
+        { "durationMs", toMilliseconds(execution.duration) },
+        { "responseSize", execution.responseSize },
+        { "phases", phases },
+      });
+    }
+
+    for (const auto& total : stats.GetTotals()) {
+      json["totals"].push_back({
+        { "name", total.name },
+        { "count", total.count },
+        { "durationMs", toMilliseconds(total.duration) },
+        { "maxDurationMs", toMilliseconds(total.maxDuration) },
+      });
+    }
+
+    return json.dump();
+  }
+
+private:
+  static double toMilliseconds(gui::PhaseTimings::Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  }
+
+  LootState& state_;
+};
+}
+
+#endif
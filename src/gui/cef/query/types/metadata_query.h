@@ -25,6 +25,10 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_METADATA_QUERY
 #define LOOT_GUI_QUERY_METADATA_QUERY
 
+#include <functional>
+#include <map>
+#include <sstream>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
@@ -37,10 +41,29 @@ along with LOOT.  If not, see
 namespace loot {
 class MetadataQuery : public Query {
 protected:
-  MetadataQuery(LootState& state) : state_(state) {}
-
-  std::vector<SimpleMessage> getGeneralMessages() const {
-    std::vector<Message> messages = state_.getCurrentGame().GetMessages();
+  MetadataQuery(LootState& state,
+                std::shared_ptr<EventSink> events = nullptr) :
+      Query(events),
+      state_(state) {}
+
+  // Query temporaries are allocated from the query's arena.
+  typedef std::vector<SimpleMessage, gui::ArenaAllocator<SimpleMessage>>
+      SimpleMessages;
+  typedef std::shared_ptr<const PluginInterface> Plugin;
+  typedef std::vector<Plugin, gui::ArenaAllocator<Plugin>> Plugins;
+
+  /* Load order violations are checked for the current load order, so they
+     shouldn't be included when a different load order is being shown. */
+  SimpleMessages getGeneralMessages(
+      bool includeLoadOrderViolations = true) const {
+    auto snapshot = state_.getCurrentGame().GetSnapshot();
+    auto messages = snapshot->GetMessages();
+
+    if (includeLoadOrderViolations) {
+      for (const auto& violation : state_.getCurrentGame().CheckLoadOrder()) {
+        messages.push_back(gui::Game::ToMessage(violation));
+      }
+    }
 
     return toSimpleMessages(messages, state_.getLanguage());
   }
@@ -77,6 +100,7 @@ protected:
 
   DerivedPluginMetadata generateDerivedMetadata(
       const std::shared_ptr<const PluginInterface>& plugin) {
+    gui::PhaseTimer timer("deriveMetadata");
     auto logger = state_.getLogger();
     if (logger) {
       logger->trace("Getting masterlist metadata for: {}", plugin->GetName());
@@ -105,35 +129,243 @@ protected:
     return derived;
   }
 
+  static std::string serialise(const nlohmann::json& json) {
+    gui::PhaseTimer timer("serialiseJson");
+    return json.dump();
+  }
+
+  Plugins getPluginsInLoadOrder(const gui::GameSnapshot& snapshot) {
+    Plugins plugins;
+    for (const auto& pluginName : snapshot.GetLoadOrder()) {
+      try {
+        plugins.push_back(state_.getCurrentGame().GetPlugin(pluginName));
+      } catch (...) {
+      }
+    }
+
+    return plugins;
+  }
+
   std::string generateJsonResponse(const std::string& pluginName) {
     nlohmann::json json = generateDerivedMetadata(pluginName);
 
-    return json.dump();
+    return serialise(json);
   }
 
+  /* clientVersions maps the names of game-wide data blocks to the versions
+     the client already holds. Blocks with matching versions are omitted from
+     the response and listed in its "notModified" array instead. If
+     derivedCacheKey is not empty, the plugins' derived metadata is reused
+     from the game's cache if it was stored with the same key, and is stored
+     there otherwise, and the key is given as the "derivedPlugins" version so
+     that the client can ask for only what has changed since. */
   template<typename InputIterator>
-  std::string generateJsonResponse(InputIterator firstPlugin,
-                                   InputIterator lastPlugin) {
+  std::string generateJsonResponse(
+      InputIterator firstPlugin,
+      InputIterator lastPlugin,
+      const nlohmann::json& clientVersions = nlohmann::json::object(),
+      const std::string& derivedCacheKey = "") {
     nlohmann::json json = {
       { "folder", state_.getCurrentGame().FolderName() },
-      { "masterlist", getMasterlistInfo() },
-      { "generalMessages", getGeneralMessages() },
-      { "bashTags", state_.getCurrentGame().GetKnownBashTags() },
       { "plugins", nlohmann::json::array() },
+      { "versions", nlohmann::json::object() },
+      { "notModified", nlohmann::json::array() },
     };
 
+    const std::string metadataVersion =
+        std::to_string(state_.getCurrentGame().GetMetadataGeneration());
+    addVersionedBlock(json, "masterlist", metadataVersion, clientVersions, [&]() {
+      return nlohmann::json(getMasterlistInfo());
+    });
+    addVersionedBlock(json, "bashTags", metadataVersion, clientVersions, [&]() {
+      return nlohmann::json(state_.getCurrentGame().GetKnownBashTags());
+    });
+
+    nlohmann::json generalMessages = getGeneralMessages();
+    addVersionedBlock(json,
+                      "generalMessages",
+                      hashContent(generalMessages),
+                      clientVersions,
+                      [&]() { return generalMessages; });
+
+    if (!derivedCacheKey.empty())
+      json["versions"]["derivedPlugins"] = derivedCacheKey;
+
+    auto cachedPlugins =
+        state_.getCurrentGame().GetCachedDerivedData(derivedCacheKey);
+    if (!cachedPlugins.empty()) {
+      json["plugins"] = nlohmann::json::parse(cachedPlugins);
+      return serialise(json);
+    }
+
+    const std::string progressMessage =
+        boost::locale::translate("Parsing, merging and evaluating metadata...")
+            .str();
+    const size_t total = std::distance(firstPlugin, lastPlugin);
+    size_t done = 0;
     for (auto it = firstPlugin; it != lastPlugin; ++it) {
+      sendProgressUpdate(
+          "deriveMetadata", progressMessage, done, total, (*it)->GetName());
       json["plugins"].push_back(generateDerivedMetadata(*it));
+      ++done;
     }
 
-    return json.dump();
+    if (!derivedCacheKey.empty()) {
+      state_.getCurrentGame().CacheDerivedData(derivedCacheKey,
+                                               json["plugins"].dump());
+    }
+
+    return serialise(json);
+  }
+
+  /* Derives the metadata of the given plugins and caches it under the
+     snapshot's derived cache key. Only the metadata that differs from what
+     was cached under clientVersion is returned, or all of it if that version
+     is no longer cached. If only the snapshot has changed since, and no
+     plugin has been added, removed, moved, activated or deactivated, a
+     plugin's cached metadata is reused unless its own facts have changed.
+     Otherwise every plugin is derived again, as a plugin's messages can
+     depend on other plugins, e.g. on whether its masters are active. */
+  nlohmann::json generateChangedDerivedMetadata(
+      const gui::GameSnapshot& snapshot,
+      const std::string& clientVersion) {
+    std::map<std::string,
+             nlohmann::json,
+             std::less<std::string>,
+             gui::ArenaAllocator<std::pair<const std::string, nlohmann::json>>>
+        clientPlugins;
+    // The cached plugins are in the load order they were derived for.
+    std::vector<std::pair<std::string, bool>> cachedLoadOrder;
+    auto cachedPlugins =
+        state_.getCurrentGame().GetCachedDerivedData(clientVersion);
+    if (!cachedPlugins.empty()) {
+      for (auto& plugin : nlohmann::json::parse(cachedPlugins)) {
+        auto name = plugin.at("name").get<std::string>();
+        cachedLoadOrder.emplace_back(name, plugin.value("isActive", false));
+        clientPlugins.emplace(name, std::move(plugin));
+      }
+    }
+
+    const std::string version = getDerivedCacheKey(snapshot);
+    const auto plugins = getPluginsInLoadOrder(snapshot);
+    const bool onlySnapshotChanged =
+        !clientPlugins.empty() &&
+        getDerivationInputs(clientVersion) == getDerivationInputs(version) &&
+        hasSameLoadOrder(cachedLoadOrder, plugins, snapshot);
+
+    auto changedPlugins = nlohmann::json::array();
+    auto derivedPlugins = nlohmann::json::array();
+    for (const auto& plugin : plugins) {
+      auto it = clientPlugins.find(plugin->GetName());
+      if (onlySnapshotChanged && it != clientPlugins.end()) {
+        auto facts = snapshot.GetPluginFacts(plugin->GetName());
+        if (facts != nullptr && matchesFacts(it->second, *facts)) {
+          derivedPlugins.push_back(std::move(it->second));
+          continue;
+        }
+      }
+
+      nlohmann::json derived = generateDerivedMetadata(plugin);
+      if (it == clientPlugins.end() || it->second != derived)
+        changedPlugins.push_back(derived);
+
+      derivedPlugins.push_back(std::move(derived));
+    }
+
+    auto logger = state_.getLogger();
+    if (logger) {
+      logger->debug("{} plugins' derived metadata has changed since it was "
+                    "last sent.",
+                    changedPlugins.size());
+    }
+
+    state_.getCurrentGame().CacheDerivedData(version, derivedPlugins.dump());
+
+    return changedPlugins;
+  }
+
+  /* Derived metadata depends on the loaded plugins, the installed files
+     that metadata conditions check, the loaded metadata and the language that
+     messages are selected for. A game is only reused without reloading its
+     plugins, and so publishing a new snapshot, if its files are unchanged
+     (see Game::GetInstallFingerprint()). */
+  std::string getDerivedCacheKey(const gui::GameSnapshot& snapshot) const {
+    return std::to_string(snapshot.GetVersion()) + ":" +
+           std::to_string(
+               state_.getCurrentGame().GetLoadedInstallFingerprint()) +
+           ":" +
+           std::to_string(state_.getCurrentGame().GetMetadataGeneration()) +
+           ":" + state_.getLanguage();
   }
 
 private:
-  static std::vector<SimpleMessage> toSimpleMessages(
-      const std::vector<Message>& messages,
-      const std::string& language) {
-    std::vector<SimpleMessage> simpleMessages(messages.size());
+  template<typename BlockGetter>
+  static void addVersionedBlock(nlohmann::json& json,
+                                const std::string& name,
+                                const std::string& version,
+                                const nlohmann::json& clientVersions,
+                                BlockGetter getBlock) {
+    json["versions"][name] = version;
+
+    auto it = clientVersions.find(name);
+    if (it != clientVersions.end() && it->is_string() &&
+        it->get<std::string>() == version) {
+      json["notModified"].push_back(name);
+    } else {
+      json[name] = getBlock();
+    }
+  }
+
+  // Everything in a derived cache key apart from the snapshot version.
+  static std::string getDerivationInputs(const std::string& derivedCacheKey) {
+    auto pos = derivedCacheKey.find(':');
+    if (pos == std::string::npos)
+      return "";
+
+    return derivedCacheKey.substr(pos + 1);
+  }
+
+  static bool hasSameLoadOrder(
+      const std::vector<std::pair<std::string, bool>>& cachedLoadOrder,
+      const Plugins& plugins,
+      const gui::GameSnapshot& snapshot) {
+    if (cachedLoadOrder.size() != plugins.size())
+      return false;
+
+    for (size_t i = 0; i < plugins.size(); ++i) {
+      auto facts = snapshot.GetPluginFacts(plugins[i]->GetName());
+      if (facts == nullptr ||
+          cachedLoadOrder[i].first != plugins[i]->GetName() ||
+          cachedLoadOrder[i].second != facts->isActive)
+        return false;
+    }
+
+    return true;
+  }
+
+  static bool matchesFacts(const nlohmann::json& derived,
+                           const gui::GameSnapshot::PluginFacts& facts) {
+    return derived.value("version", "") == facts.version &&
+           derived.value("crc", uint32_t(0)) == facts.crc &&
+           derived.value("isActive", false) == facts.isActive &&
+           derived.value("isMaster", false) == facts.isMaster &&
+           derived.value("isLightMaster", false) == facts.isLightMaster &&
+           derived.value("isEmpty", false) == facts.isEmpty &&
+           derived.value("loadsArchive", false) == facts.loadsArchive &&
+           derived.value("loadOrderIndex", short(-1)) ==
+               facts.activeLoadOrderIndex;
+  }
+
+  static std::string hashContent(const nlohmann::json& content) {
+    std::stringstream stream;
+    stream << std::hex << std::hash<std::string>()(content.dump());
+
+    return stream.str();
+  }
+
+  static SimpleMessages toSimpleMessages(const std::vector<Message>& messages,
+                                         const std::string& language) {
+    SimpleMessages simpleMessages(messages.size());
     std::transform(begin(messages),
                    end(messages),
                    begin(simpleMessages),
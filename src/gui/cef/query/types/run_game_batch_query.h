@@ -0,0 +1,106 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_RUN_GAME_BATCH_QUERY
+#define LOOT_GUI_QUERY_RUN_GAME_BATCH_QUERY
+
+#include <algorithm>
+#include <chrono>
+
+#include "gui/cef/query/json.h"
+#include "gui/cef/query/query.h"
+#include "gui/state/loot_state.h"
+
+namespace loot {
+// Sorts and validates the given games, or all installed games if none are
+// given, at once. If profile paths are given, the current game's profiles are
+// processed instead. Sorted load orders are only saved if
+// applySortedLoadOrder is true.
+class RunGameBatchQuery : public Query {
+public:
+  RunGameBatchQuery(LootState& state,
+                    const std::vector<std::string>& gameFolders,
+                    const std::vector<std::string>& profilePaths,
+                    bool applySortedLoadOrder) :
+      state_(state),
+      gameFolders_(gameFolders),
+      profilePaths_(profilePaths),
+      applySortedLoadOrder_(applySortedLoadOrder) {}
+
+  std::string executeLogic() {
+    auto start = std::chrono::steady_clock::now();
+
+    gui::GameBatchOptions options;
+    options.updateMasterlist = state_.updateMasterlist();
+    options.applySortedLoadOrder = applySortedLoadOrder_;
+    options.language = state_.getLanguage();
+    std::vector<gui::GameBatchResult> results;
+    if (profilePaths_.empty()) {
+      results = state_.runGameBatch(gameFolders_, options);
+
+      // The batch may have changed the current game's masterlist or load
+      // order behind the UI's back.
+      auto currentFolder = state_.getCurrentGame().FolderName();
+      bool isCurrentGameChanged = std::any_of(
+          begin(results),
+          end(results),
+          [&](const gui::GameBatchResult& result) {
+            return result.folderName == currentFolder &&
+                   (result.isApplied || result.isMasterlistUpdated);
+          });
+      if (isCurrentGameChanged)
+        sendInvalidation("game");
+    } else if (gameFolders_.empty()) {
+      results = state_.runProfileBatch(profilePaths_, options);
+    } else {
+      throw std::invalid_argument(
+          "Profiles can only be given for the current game");
+    }
+
+    std::chrono::milliseconds duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    nlohmann::json json = {
+      { "games", results },
+      { "valid",
+        std::all_of(begin(results),
+                    end(results),
+                    [](const gui::GameBatchResult& result) {
+                      return result.isValid;
+                    }) },
+      { "durationMs", duration.count() },
+    };
+
+    return json.dump();
+  }
+
+private:
+  LootState& state_;
+  const std::vector<std::string> gameFolders_;
+  const std::vector<std::string> profilePaths_;
+  const bool applySortedLoadOrder_;
+};
+}
+
+#endif
@@ -25,20 +25,29 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_SORT_PLUGINS_QUERY
 #define LOOT_GUI_QUERY_SORT_PLUGINS_QUERY
 
+#include <stdexcept>
 
 #include <boost/locale.hpp>
 
 #include "gui/cef/query/json.h"
 #include "gui/cef/query/types/metadata_query.h"
+#include "gui/state/load_order_moves.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
 class SortPluginsQuery : public MetadataQuery {
 public:
-  SortPluginsQuery(LootState& state, CefRefPtr<CefFrame> frame) :
-      MetadataQuery(state),
+  /* If clientVersions holds the "derivedPlugins" version of the client's
+     plugin data, the sorted load order is given as the moves that get it
+     from the current load order, and only plugins whose derived metadata
+     has changed since that version are included. */
+  SortPluginsQuery(LootState& state,
+                   std::shared_ptr<EventSink> events,
+                   const nlohmann::json& clientVersions =
+                       nlohmann::json::object()) :
+      MetadataQuery(state, events),
       state_(state),
-      frame_(frame) {}
+      clientVersions_(clientVersions) {}
 
   std::string executeLogic() {
     auto logger = state_.getLogger();
@@ -46,8 +55,14 @@ public:
       logger->info("Beginning sorting operation.");
     }
 
+    // Sorting fully loads the plugins itself, so a background load would
+    // only compete with it for CPU time. That's not the case if the last
+    // sort result gets reused.
+    if (!state_.getCurrentGame().IsSortResultStored())
+      state_.cancelBackgroundPluginLoad();
+
     // Sort plugins into their load order.
-    sendProgressUpdate(frame_,
+    sendProgressUpdate("sort",
                        boost::locale::translate("Sorting load order..."));
     std::vector<std::string> plugins = state_.getCurrentGame().SortPlugins();
 
@@ -56,7 +71,11 @@ public:
          state_.getCurrentGame().Type() == GameType::tes5se))
       applyUnchangedLoadOrder(plugins);
 
-    std::string json = generateJsonResponse(plugins);
+    auto clientVersion = clientVersions_.find("derivedPlugins");
+    std::string json =
+        clientVersion != clientVersions_.end() && clientVersion->is_string()
+            ? generateMovesJsonResponse(plugins, *clientVersion)
+            : generateJsonResponse(plugins);
 
     // plugins will be empty if there was a sorting error.
     if (!plugins.empty())
@@ -80,22 +99,77 @@ private:
   }
 
   std::string generateJsonResponse(const std::vector<std::string>& plugins) {
+    // A successful sort satisfies all load order constraints.
     nlohmann::json json = {
-      { "generalMessages", getGeneralMessages() },
+      { "generalMessages", getGeneralMessages(plugins.empty()) },
       { "plugins", nlohmann::json::array() },
     };
 
+    const std::string progressMessage =
+        boost::locale::translate("Sorting load order...").str();
+    size_t done = 0;
     for (const auto& pluginName : plugins) {
+      sendProgressUpdate(
+          "deriveMetadata", progressMessage, done, plugins.size(), pluginName);
+
       auto plugin = state_.getCurrentGame().GetPlugin(pluginName);
 
       json["plugins"].push_back(generateDerivedMetadata(plugin));
+      ++done;
+    }
+
+    return serialise(json);
+  }
+
+  std::string generateMovesJsonResponse(
+      const std::vector<std::string>& plugins,
+      const std::string& clientVersion) {
+    // There's nothing to move if sorting failed.
+    if (plugins.empty())
+      return generateJsonResponse(plugins);
+
+    auto snapshot = state_.getCurrentGame().GetSnapshot();
+    std::vector<std::string> loadOrder;
+    for (const auto& plugin : getPluginsInLoadOrder(*snapshot)) {
+      loadOrder.push_back(plugin->GetName());
+    }
+
+    std::vector<gui::LoadOrderMove> moves;
+    try {
+      moves = gui::getLoadOrderMoves(loadOrder, plugins);
+    } catch (std::invalid_argument&) {
+      // The client's plugins don't match the sorted plugins, so it needs
+      // them all.
+      return generateJsonResponse(plugins);
+    }
+
+    auto logger = state_.getLogger();
+    if (logger) {
+      logger->debug("Sorting moved {} of {} plugins.",
+                    moves.size(),
+                    plugins.size());
+    }
+
+    const std::string version = getDerivedCacheKey(*snapshot);
+    nlohmann::json json = {
+      { "generalMessages", getGeneralMessages(false) },
+      { "moves", moves },
+      { "plugins", nlohmann::json::array() },
+      { "versions", { { "derivedPlugins", version } } },
+    };
+
+    if (clientVersion != version) {
+      sendProgressUpdate(
+          "deriveMetadata",
+          boost::locale::translate("Sorting load order...").str());
+      json["plugins"] = generateChangedDerivedMetadata(*snapshot, clientVersion);
     }
 
-    return json.dump();
+    return serialise(json);
   }
 
   LootState& state_;
-  CefRefPtr<CefFrame> frame_;
+  const nlohmann::json clientVersions_;
 };
 }
 
@@ -33,7 +33,7 @@ class UpdateMasterlistQuery : public MetadataQuery {
 public:
   UpdateMasterlistQuery(LootState& state) :
       MetadataQuery(state),
-      game_(state.getCurrentGame()) {}
+      state_(state) {}
 
   std::string executeLogic() {
     auto logger = getLogger();
@@ -41,27 +41,30 @@ public:
       logger->debug("Updating and parsing masterlist.");
     }
 
-    if (!updateMasterlist())
+    // Look up the game now rather than on construction, in case the current
+    // game changed while this query was waiting to run.
+    gui::Game& game = state_.getCurrentGame();
+    if (!updateMasterlist(game))
       return "null";
 
-    auto plugins = game_.GetPlugins();
+    auto plugins = game.GetPlugins();
     return generateJsonResponse(plugins.cbegin(), plugins.cend());
   }
 
 private:
-  bool updateMasterlist() {
+  bool updateMasterlist(gui::Game& game) {
     try {
-      return game_.UpdateMasterlist();
+      return game.UpdateMasterlist();
     } catch (std::exception&) {
       try {
-        game_.LoadMetadata();
+        game.LoadMetadata();
       } catch (...) {
       }
       throw;
     }
   }
 
-  gui::Game& game_;
+  LootState& state_;
 };
 }
 
@@ -0,0 +1,81 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_VALIDATE_LOAD_ORDER_QUERY
+#define LOOT_GUI_QUERY_VALIDATE_LOAD_ORDER_QUERY
+
+#include "gui/cef/query/json.h"
+#include "gui/cef/query/types/metadata_query.h"
+#include "gui/state/loot_state.h"
+
+namespace loot {
+// Lists the general messages and the plugins with messages for the current
+// load order, which is valid if none of the messages are warnings or errors.
+// The game's plugins and metadata must already have been loaded.
+class ValidateLoadOrderQuery : public MetadataQuery {
+public:
+  ValidateLoadOrderQuery(LootState& state) :
+      MetadataQuery(state),
+      state_(state) {}
+
+  std::string executeLogic() {
+    auto snapshot = state_.getCurrentGame().GetSnapshot();
+
+    nlohmann::json json = {
+      { "generalMessages", getGeneralMessages() },
+      { "plugins", nlohmann::json::array() },
+    };
+    bool isValid = !hasProblems(json["generalMessages"]);
+
+    for (const auto& plugin : getPluginsInLoadOrder(*snapshot)) {
+      nlohmann::json derived = generateDerivedMetadata(plugin);
+      if (derived["messages"].empty())
+        continue;
+
+      isValid = isValid && !hasProblems(derived["messages"]);
+      json["plugins"].push_back({
+        { "name", derived["name"] },
+        { "messages", derived["messages"] },
+      });
+    }
+
+    json["valid"] = isValid;
+
+    return serialise(json);
+  }
+
+private:
+  static bool hasProblems(const nlohmann::json& messages) {
+    for (const auto& message : messages) {
+      if (message.at("type") != "say")
+        return true;
+    }
+    return false;
+  }
+
+  LootState& state_;
+};
+}
+
+#endif
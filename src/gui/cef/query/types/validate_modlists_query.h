@@ -0,0 +1,133 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_VALIDATE_MODLISTS_QUERY
+#define LOOT_GUI_QUERY_VALIDATE_MODLISTS_QUERY
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gui/cef/query/json.h"
+#include "gui/cef/query/query.h"
+#include "gui/state/loot_paths.h"
+#include "gui/state/loot_state.h"
+#include "gui/state/modlist_batch.h"
+
+namespace loot {
+// Checks the modlists described by the given manifest files. Each manifest is
+// a JSON object with the modlist's name, the LOOT folder name of its game, and
+// its plugins in load order. Plugins are given as paths, relative to the
+// manifest or absolute, or as objects with a path and whether the plugin is
+// active. Plugins are active by default.
+class ValidateModlistsQuery : public Query {
+public:
+  ValidateModlistsQuery(LootState& state,
+                        const std::vector<std::string>& manifestPaths,
+                        const std::string& workPath,
+                        unsigned int threads) :
+      state_(state),
+      manifestPaths_(manifestPaths),
+      workPath_(workPath),
+      threads_(threads) {}
+
+  std::string executeLogic() {
+    std::vector<gui::ModlistManifest> manifests;
+    for (const auto& path : manifestPaths_) {
+      manifests.push_back(readManifest(path));
+    }
+
+    gui::ModlistBatchOptions options;
+    options.lootDataPath = LootPaths::getLootDataPath();
+    options.threads = threads_;
+    options.language = state_.getLanguage();
+    options.workPath = workPath_;
+
+    // Without a work path, stage the modlists somewhere that is cleaned up
+    // afterwards.
+    bool removeWorkPath = options.workPath.empty();
+    if (removeWorkPath) {
+      options.workPath = boost::filesystem::temp_directory_path() /
+                         boost::filesystem::unique_path("loot-%%%%-%%%%");
+    }
+
+    auto result = gui::runModlistBatch(manifests, options);
+
+    if (removeWorkPath) {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(options.workPath, ec);
+    }
+
+    nlohmann::json json = result;
+
+    return json.dump();
+  }
+
+private:
+  gui::ModlistManifest readManifest(const boost::filesystem::path& path) {
+    boost::filesystem::ifstream in(path);
+    if (!in)
+      throw std::runtime_error("Could not read the manifest " + path.string());
+
+    nlohmann::json json = nlohmann::json::parse(in);
+
+    gui::ModlistManifest manifest;
+    manifest.name = json.value("name", path.stem().string());
+    manifest.gameSettings = getGameSettings(json.at("game"));
+
+    for (const auto& plugin : json.at("plugins")) {
+      gui::ModlistPlugin modlistPlugin;
+      if (plugin.is_string()) {
+        modlistPlugin.path = plugin.get<std::string>();
+        modlistPlugin.isActive = true;
+      } else {
+        modlistPlugin.path = plugin.at("path").get<std::string>();
+        modlistPlugin.isActive = plugin.value("active", true);
+      }
+
+      if (modlistPlugin.path.is_relative())
+        modlistPlugin.path = path.parent_path() / modlistPlugin.path;
+
+      manifest.plugins.push_back(modlistPlugin);
+    }
+
+    return manifest;
+  }
+
+  GameSettings getGameSettings(const std::string& folderName) const {
+    for (const auto& gameSettings : state_.getGameSettings()) {
+      if (boost::iequals(gameSettings.FolderName(), folderName))
+        return gameSettings;
+    }
+
+    throw std::invalid_argument("Unrecognised game folder: " + folderName);
+  }
+
+  LootState& state_;
+  const std::vector<std::string> manifestPaths_;
+  const std::string workPath_;
+  const unsigned int threads_;
+};
+}
+
+#endif
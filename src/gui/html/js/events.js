@@ -25,7 +25,7 @@ function onConflictsFilter(evt) {
       loot.l10n.translate('Identifying conflicting plugins...')
     );
     loot.filters
-      .activateConflictsFilter(evt.currentTarget.value)
+      .activateConflictsFilter(evt.currentTarget.value, loot.game.versions)
       .then(plugins => {
         plugins.forEach(plugin => {
           const gamePlugin = loot.game.plugins.find(
@@ -53,6 +53,27 @@ function onConflictsFilter(evt) {
   }
 }
 
+function onBackendEvent(event) {
+  if (event.type === 'progress' && event.background) {
+    /* Background work doesn't block the UI, so don't show it in the modal
+       progress dialog. */
+    return;
+  }
+  if (event.type === 'progress') {
+    let text = event.message;
+    if (event.total > 0) {
+      text = `${text} ${event.done}/${event.total}`;
+    }
+    loot.Dialog.showProgress(text);
+  } else if (event.type === 'invalidate') {
+    document.dispatchEvent(
+      new CustomEvent('loot-backend-invalidate', {
+        detail: { scopes: event.scopes }
+      })
+    );
+  }
+}
+
 function onChangeGame(evt) {
   if (
     evt.detail.item.getAttribute('value') === loot.game.folder ||
@@ -63,7 +84,11 @@ function onChangeGame(evt) {
   }
   /* Send off a CEF query with the folder name of the new game. */
   loot
-    .query('changeGame', evt.detail.item.getAttribute('value'))
+    .query(
+      'changeGame',
+      evt.detail.item.getAttribute('value'),
+      loot.game.versions
+    )
     .then(result => {
       /* Filters should be re-applied on game change, except the conflicts
        filter. Don't need to deactivate the others beforehand. Strictly not
@@ -82,7 +107,10 @@ function onChangeGame(evt) {
 
       /* Parse the data sent from C++. */
       const gameInfo = JSON.parse(result, loot.Plugin.fromJson);
-      loot.game = new loot.Game(gameInfo, loot.l10n);
+      loot.game = new loot.Game(
+        loot.Game.fillNotModifiedBlocks(gameInfo, loot.game),
+        loot.l10n
+      );
 
       loot.game.initialiseUI(loot.DOM, loot.Filters);
 
@@ -155,7 +183,7 @@ function onSortPlugins() {
     promise = promise.then(updateMasterlist);
   }
   promise
-    .then(() => loot.query('sortPlugins'))
+    .then(() => loot.query('sortPlugins', undefined, loot.game.versions))
     .then(JSON.parse)
     .then(result => {
       if (!result) {
@@ -163,8 +191,10 @@ function onSortPlugins() {
       }
 
       loot.game.generalMessages = result.generalMessages;
+      Object.assign(loot.game.versions, result.versions);
 
-      if (!result.plugins || result.plugins.length === 0) {
+      /* If the result has moves, plugins only holds those that changed. */
+      if (!result.moves && (!result.plugins || result.plugins.length === 0)) {
         const message = result.generalMessages.find(item =>
           item.text.startsWith('Cyclic interaction detected')
         );
@@ -180,9 +210,11 @@ function onSortPlugins() {
       }
 
       /* Check if sorted load order differs from current load order. */
-      const loadOrderIsUnchanged = result.plugins.every(
-        (plugin, index) => plugin.name === loot.game.plugins[index].name
-      );
+      const loadOrderIsUnchanged = result.moves
+        ? result.moves.length === 0
+        : result.plugins.every(
+            (plugin, index) => plugin.name === loot.game.plugins[index].name
+          );
       if (loadOrderIsUnchanged) {
         result.plugins.forEach(plugin => {
           const existingPlugin = loot.game.plugins.find(
@@ -201,21 +233,43 @@ function onSortPlugins() {
         );
         return;
       }
-      loot.game.setSortedPlugins(result.plugins);
+      const showSortedPlugins = () => {
+        /* Now update the UI for the new order. */
+        loot.filters.apply(loot.game.plugins);
 
-      /* Now update the UI for the new order. */
-      loot.filters.apply(loot.game.plugins);
+        loot.state.enterSortingState();
 
-      loot.state.enterSortingState();
+        loot.Dialog.closeProgress();
+      };
+
+      if (!result.moves) {
+        loot.game.setSortedPlugins(result.plugins);
+      } else if (
+        !loot.game.setSortedPluginMoves(result.moves, result.plugins)
+      ) {
+        /* The displayed load order has drifted from the one the moves were
+           made for, so get the whole sorted load order instead. Sorting
+           again reuses the stored sort result. */
+        return loot
+          .query('sortPlugins')
+          .then(JSON.parse)
+          .then(fullResult => {
+            loot.game.generalMessages = fullResult.generalMessages;
+            loot.game.setSortedPlugins(fullResult.plugins);
+            showSortedPlugins();
+          });
+      }
 
-      loot.Dialog.closeProgress();
+      return showSortedPlugins();
     })
     .catch(loot.handlePromiseError);
 }
 function onApplySort() {
-  const loadOrder = loot.game.getPluginNames();
+  const payload = loot.game.sortMoves
+    ? { moves: loot.game.sortMoves }
+    : loot.game.getPluginNames();
   return loot
-    .query('applySort', loadOrder)
+    .query('applySort', payload)
     .then(() => {
       loot.game.applySort();
 
@@ -339,11 +393,14 @@ function onCopyLoadOrder() {
 function onContentRefresh() {
   /* Send a query for updated load order and plugin header info. */
   loot
-    .query('getGameData')
+    .query('getGameData', undefined, loot.game.versions)
     .then(result => {
       /* Parse the data sent from C++. */
       const game = JSON.parse(result, loot.Plugin.fromJson);
-      loot.game = new loot.Game(game, loot.l10n);
+      loot.game = new loot.Game(
+        loot.Game.fillNotModifiedBlocks(game, loot.game),
+        loot.l10n
+      );
 
       /* Re-initialise conflicts filter plugin list. */
       loot.Filters.fillConflictsFilterList(loot.game.plugins);
@@ -366,6 +423,66 @@ function onOpenReadme() {
 function onOpenLogLocation() {
   loot.query('openLogLocation').catch(loot.handlePromiseError);
 }
+function onShowDiagnostics() {
+  function formatBytes(bytes) {
+    return `${(bytes / (1024 * 1024)).toFixed(1)} MiB`;
+  }
+
+  function appendRow(tableBody, cells) {
+    const row = tableBody.insertRow();
+    cells.forEach(cell => {
+      row.insertCell().textContent = cell;
+    });
+  }
+
+  loot
+    .query('getMemoryUsage')
+    .then(JSON.parse)
+    .then(result => {
+      const gameTableBody = document
+        .getElementById('gameMemoryUsage')
+        .querySelector('tbody');
+      gameTableBody.innerHTML = '';
+      result.games.forEach(game => {
+        const name = game.profile
+          ? `${game.name} (${game.profile})`
+          : game.name;
+        appendRow(gameTableBody, [
+          name,
+          formatBytes(game.bytes.plugins),
+          formatBytes(game.bytes.metadata),
+          formatBytes(game.bytes.formIdIndex),
+          formatBytes(game.bytes.derivedData),
+          formatBytes(game.bytes.state),
+          formatBytes(game.bytes.total)
+        ]);
+      });
+
+      const countedTableBody = document
+        .getElementById('countedMemoryUsage')
+        .querySelector('tbody');
+      countedTableBody.innerHTML = '';
+      result.counted.forEach(subsystem => {
+        appendRow(countedTableBody, [
+          subsystem.name,
+          formatBytes(subsystem.bytes)
+        ]);
+      });
+      if (result.heap) {
+        appendRow(countedTableBody, [
+          loot.l10n.translate('Heap allocated'),
+          formatBytes(result.heap.allocated)
+        ]);
+        appendRow(countedTableBody, [
+          loot.l10n.translate('Heap reserved'),
+          formatBytes(result.heap.reserved)
+        ]);
+      }
+
+      document.getElementById('diagnostics').open();
+    })
+    .catch(loot.handlePromiseError);
+}
 function handleUnappliedChangesClose(change) {
   loot.Dialog.askQuestion(
     '',
@@ -91,7 +91,11 @@
         return wasEnabled;
       }
 
-      activateConflictsFilter(targetPluginName) {
+      /* versions holds the versions of the client's game data, and has its
+         derivedPlugins version updated to match the plugin metadata that the
+         returned promise resolves to. Only plugins whose metadata has changed
+         since the given version are resolved to. */
+      activateConflictsFilter(targetPluginName, versions) {
         if (!targetPluginName) {
           return Promise.resolve([]);
         }
@@ -100,16 +104,28 @@
        conflicts. */
         this.conflictingPluginNames = [targetPluginName];
 
-        return query('getConflictingPlugins', targetPluginName)
+        return query('getConflictingPlugins', targetPluginName, versions)
           .then(JSON.parse)
-          .then(response =>
-            response.plugins.map(plugin => {
+          .then(response => {
+            if (response.conflicts) {
+              /* The target isn't listed if it has no records, but should
+                 still be shown. */
+              this.conflictingPluginNames = [targetPluginName].concat(
+                response.conflicts.filter(name => name !== targetPluginName)
+              );
+              if (versions) {
+                Object.assign(versions, response.versions);
+              }
+              return response.plugins;
+            }
+
+            return response.plugins.map(plugin => {
               if (plugin.conflicts) {
                 this.conflictingPluginNames.push(plugin.metadata.name);
               }
               return plugin.metadata;
-            })
-          )
+            });
+          })
           .catch(handlePromiseError);
       }
 
@@ -19,12 +19,26 @@
         this.masterlist = obj.masterlist || {};
         this.plugins = obj.plugins || [];
         this.bashTags = obj.bashTags || [];
+        this.versions = Object.assign({}, obj.versions);
 
         this.oldLoadOrder = undefined;
+        this.sortMoves = undefined;
 
         this._notApplicableString = l10n.translate('N/A');
       }
 
+      /* Fills in the blocks that the backend omitted from gameInfo because
+         previousGame already holds their current versions. */
+      static fillNotModifiedBlocks(gameInfo, previousGame) {
+        const filled = Object.assign({}, gameInfo);
+        (gameInfo.notModified || []).forEach(blockName => {
+          filled[blockName] = previousGame[blockName];
+        });
+        delete filled.notModified;
+
+        return filled;
+      }
+
       get folder() {
         return this._folder;
       }
@@ -95,6 +109,11 @@
         }
 
         this._generalMessages = generalMessages;
+
+        /* The stored version no longer describes the stored messages. */
+        if (this.versions) {
+          delete this.versions.generalMessages;
+        }
       }
 
       get masterlist() {
@@ -126,6 +145,10 @@
         }
 
         this._masterlist = masterlist;
+
+        if (this.versions) {
+          delete this.versions.masterlist;
+        }
       }
 
       get plugins() {
@@ -246,13 +269,66 @@
         this.plugins = newPlugins;
       }
 
+      /* Reorders the plugins by making the given moves, which are given
+         relative to the current order, and updates the given plugins.
+         Returns false and changes nothing if a move's plugin isn't where the
+         move says it is, as then the current order has drifted from the one
+         that the moves were made for. */
+      setSortedPluginMoves(moves, plugins) {
+        const movesMatch = moves.every(
+          move =>
+            move.from < this.plugins.length &&
+            move.to < this.plugins.length &&
+            this.plugins[move.from].name === move.name
+        );
+        if (!movesMatch) {
+          return false;
+        }
+
+        this.oldLoadOrder = this.plugins;
+        this.sortMoves = moves;
+
+        const newPlugins = new Array(this.oldLoadOrder.length);
+        const isMoved = new Array(this.oldLoadOrder.length).fill(false);
+        moves.forEach(move => {
+          newPlugins[move.to] = this.oldLoadOrder[move.from];
+          isMoved[move.from] = true;
+        });
+
+        /* Unmoved plugins fill the gaps in their existing relative order. */
+        let to = 0;
+        this.oldLoadOrder.forEach((plugin, from) => {
+          if (!isMoved[from]) {
+            while (newPlugins[to] !== undefined) {
+              to += 1;
+            }
+            newPlugins[to] = plugin;
+          }
+        });
+
+        plugins.forEach(plugin => {
+          const existingPlugin = newPlugins.find(
+            item => item.name === plugin.name
+          );
+          if (existingPlugin) {
+            existingPlugin.update(plugin);
+          }
+        });
+
+        this.plugins = newPlugins;
+
+        return true;
+      }
+
       applySort() {
         this.oldLoadOrder = undefined;
+        this.sortMoves = undefined;
       }
 
       cancelSort(plugins, generalMessages) {
         this.plugins = this.oldLoadOrder;
         this.oldLoadOrder = undefined;
+        this.sortMoves = undefined;
 
         plugins.forEach(plugin => {
           const existingPlugin = this.plugins.find(
@@ -40,6 +40,7 @@
       root.loot.translateStaticText,
       root.loot.Plugin,
       root.loot.query,
+      root.loot.subscribe,
       root.loot.Translator,
       root.loot.updateExists
     );
@@ -55,6 +56,7 @@
     translateStaticText,
     Plugin,
     query,
+    subscribe,
     Translator,
     updateExists
   ) => {
@@ -104,6 +106,9 @@
       document
         .getElementById('openLogButton')
         .addEventListener('click', onOpenLogLocation);
+      document
+        .getElementById('diagnosticsButton')
+        .addEventListener('click', onShowDiagnostics);
       document
         .getElementById('wipeUserlistButton')
         .addEventListener('click', onClearAllMetadata);
@@ -338,6 +343,7 @@
         sanitize: true
       });
       setupEventHandlers();
+      subscribe(onBackendEvent); // eslint-disable-line no-undef
 
       loot.version = {};
       loot.settings = {};
@@ -9,7 +9,7 @@
     root.loot = root.loot || {};
     root.loot.query = factory(root._);
   }
-})(this, _ => (requestName, payload) => {
+})(this, _ => (requestName, payload, versions) => {
   if (!requestName) {
     throw new Error('No request name passed');
   }
@@ -23,6 +23,8 @@
       };
     } else if (_.isString(payload)) {
       request.targetName = payload;
+    } else if (payload.moves) {
+      request.moves = payload.moves;
     } else if (payload.name) {
       request.filter = payload;
     } else if (payload.messages) {
@@ -35,6 +37,9 @@
       request.editorState = payload;
     }
   }
+  if (versions) {
+    request.versions = versions;
+  }
 
   return new Promise((resolve, reject) => {
     window.cefQuery({
@@ -0,0 +1,29 @@
+'use strict';
+
+(function exportModule(root, factory) {
+  if (typeof define === 'function' && define.amd) {
+    // AMD. Register as an anonymous module.
+    define([], factory);
+  } else {
+    // Browser globals
+    root.loot = root.loot || {};
+    root.loot.subscribe = factory();
+  }
+})(this, () => onEvent => {
+  if (typeof onEvent !== 'function') {
+    throw new Error('No event handler passed');
+  }
+
+  /* The subscription stays open for the lifetime of the page, so each
+     success callback delivers one event pushed by the backend. */
+  return window.cefQuery({
+    request: JSON.stringify({ name: 'subscribe' }),
+    persistent: true,
+    onSuccess: response => {
+      onEvent(JSON.parse(response));
+    },
+    onFailure: (errorCode, errorMessage) => {
+      console.log(`Event subscription failed: ${errorMessage}`); // eslint-disable-line no-console
+    }
+  });
+});
@@ -461,6 +461,9 @@
     document.getElementById(
       'openLogButton'
     ).lastChild.textContent = l10n.translate('Open Debug Log Location');
+    document.getElementById(
+      'diagnosticsButton'
+    ).lastChild.textContent = l10n.translate('View Diagnostics');
     document.getElementById(
       'wipeUserlistButton'
     ).lastChild.textContent = l10n.translate('Clear All User Metadata');
@@ -763,6 +766,24 @@
     );
   }
 
+  function translateDiagnosticsDialog(l10n) {
+    const diagnostics = document.getElementById('diagnostics');
+    diagnostics.querySelector('h2').textContent = l10n.translate('Diagnostics');
+
+    const headings = diagnostics.getElementsByTagName('h3');
+    headings[0].textContent = l10n.translate('Memory Used By Games');
+    headings[1].textContent = l10n.translate('Counted Memory');
+
+    const columns = diagnostics.getElementsByTagName('th');
+    columns[0].textContent = l10n.translate('Game');
+    columns[1].textContent = l10n.translate('Plugins');
+    columns[2].textContent = l10n.translate('Metadata');
+    columns[3].textContent = l10n.translate('FormID Index');
+    columns[4].textContent = l10n.translate('Derived Data');
+    columns[5].textContent = l10n.translate('Other');
+    columns[6].textContent = l10n.translate('Total');
+  }
+
   return (l10n, version) => {
     translatePluginCardInstance(l10n);
     translatePluginCardTemplate(l10n);
@@ -787,5 +808,6 @@
     translateSettingsDialog(l10n);
     translateFirstRunDialog(l10n, version);
     translateAboutDialog(l10n, version);
+    translateDiagnosticsDialog(l10n);
   };
 });
@@ -0,0 +1,204 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/background_plugin_loader.h"
+
+#include <algorithm>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/locale.hpp>
+
+#include "gui/state/logging.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace loot {
+namespace gui {
+BackgroundPluginLoader::BackgroundPluginLoader() :
+    cancelled_(false),
+    running_(false),
+    logger_(getLogger()) {}
+
+BackgroundPluginLoader::~BackgroundPluginLoader() { Cancel(); }
+
+void BackgroundPluginLoader::Start(Game& game,
+                                   unsigned int maxThreads,
+                                   std::shared_ptr<EventSink> events) {
+  Cancel();
+
+  if (game.ArePluginsFullyLoaded()) {
+    return;
+  }
+
+  // Everything that reads the game's state is done here, on the caller's
+  // thread, so the loader thread only ever touches the game to hand over its
+  // results.
+  auto pluginNames = game.GetInstalledPluginNames();
+  if (pluginNames.empty()) {
+    return;
+  }
+
+  auto pluginsLoadId = game.GetPluginsLoadId();
+  auto handle = game.CreateDetachedGameHandle();
+  auto batchSize = GetBatchSize(maxThreads);
+
+  if (logger_) {
+    logger_->debug(
+        "Starting background load of {} plugins, {} at a time.",
+        pluginNames.size(),
+        batchSize);
+  }
+
+  cancelled_ = false;
+  running_ = true;
+  thread_ = std::thread(&BackgroundPluginLoader::Run,
+                        this,
+                        std::ref(game),
+                        handle,
+                        pluginNames,
+                        pluginsLoadId,
+                        batchSize,
+                        game.GetFormIdIndex(),
+                        game.Type(),
+                        game.DataPath(),
+                        events);
+}
+
+void BackgroundPluginLoader::Cancel() {
+  if (!thread_.joinable()) {
+    return;
+  }
+
+  cancelled_ = true;
+  thread_.join();
+}
+
+bool BackgroundPluginLoader::IsRunning() const { return running_; }
+
+void BackgroundPluginLoader::Run(Game& game,
+                                 std::shared_ptr<GameInterface> handle,
+                                 std::vector<std::string> pluginNames,
+                                 unsigned int pluginsLoadId,
+                                 size_t batchSize,
+                                 std::shared_ptr<FormIdIndex> formIdIndex,
+                                 GameType gameType,
+                                 boost::filesystem::path dataPath,
+                                 std::shared_ptr<EventSink> events) {
+  LowerThreadPriority();
+
+  // Bring the FormID index up to date first, as it can usually reuse what
+  // was stored last session, and then conflicts can be checked straight away.
+  try {
+    formIdIndex->Update(gameType, dataPath, pluginNames, &cancelled_);
+  } catch (std::exception& e) {
+    if (logger_) {
+      logger_->error("FormID index update failed. Details: {}", e.what());
+    }
+  }
+
+  const std::string message =
+      boost::locale::translate("Loading plugins in the background...").str();
+  std::map<std::string, FullLoadData> fullLoadData;
+
+  try {
+    for (size_t first = 0; first < pluginNames.size(); first += batchSize) {
+      if (cancelled_) {
+        if (logger_) {
+          logger_->debug("Background plugin load cancelled.");
+        }
+        running_ = false;
+        return;
+      }
+
+      auto last = std::min(first + batchSize, pluginNames.size());
+      std::vector<std::string> batch(pluginNames.begin() + first,
+                                     pluginNames.begin() + last);
+
+      // Loading a batch replaces the handle's previously loaded plugins, so
+      // only one batch's records are held at a time.
+      handle->LoadPlugins(batch, false);
+      for (const auto& plugin : handle->GetLoadedPlugins()) {
+        fullLoadData.emplace(boost::to_lower_copy(plugin->GetName()),
+                             FullLoadData(*plugin));
+      }
+
+      if (events) {
+        events->sendProgress(ProgressEvent(
+            "backgroundLoad", message, last, pluginNames.size(), "", true));
+      }
+    }
+  } catch (std::exception& e) {
+    if (logger_) {
+      logger_->error("Background plugin load failed. Details: {}", e.what());
+    }
+    running_ = false;
+    return;
+  }
+
+  if (!cancelled_ && game.AdoptFullLoadData(fullLoadData, pluginsLoadId)) {
+    if (logger_) {
+      logger_->debug("Background plugin load complete.");
+    }
+  }
+
+  if (!cancelled_) {
+    // Knowing the CRCs lets the next session reuse plugins that have only
+    // been redated.
+    std::map<std::string, uint32_t> crcs;
+    for (const auto& data : fullLoadData) {
+      crcs.emplace(data.first, data.second.crc);
+    }
+    formIdIndex->SetCrcs(crcs);
+  }
+
+  if (events) {
+    events->flush();
+  }
+
+  running_ = false;
+}
+
+size_t BackgroundPluginLoader::GetBatchSize(unsigned int maxThreads) {
+  if (maxThreads > 0) {
+    return maxThreads;
+  }
+
+  return std::max(1u, std::thread::hardware_concurrency() / 2);
+}
+
+void BackgroundPluginLoader::LowerThreadPriority() {
+#ifdef _WIN32
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+#else
+  // On Linux, nice values are per-thread, and are inherited by any threads
+  // that the LOOT API creates while loading.
+  setpriority(PRIO_PROCESS, 0, 19);
+#endif
+}
+}
+}
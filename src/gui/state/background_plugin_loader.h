@@ -0,0 +1,93 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_BACKGROUND_PLUGIN_LOADER
+#define LOOT_GUI_STATE_BACKGROUND_PLUGIN_LOADER
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "gui/state/event_sink.h"
+#include "gui/state/game.h"
+
+namespace loot {
+namespace gui {
+/**
+ * Fully loads a game's installed plugins on a low-priority thread, so that
+ * data that is only available from fully loaded plugins (e.g. CRCs) is ready
+ * by the time the user asks for it. The game's FormID index is brought up to
+ * date before the plugins are loaded, and given their CRCs afterwards. Only
+ * the data that LOOT uses is kept from each batch, and the game is given it
+ * to use with its loaded plugin headers, so the plugins' records are never
+ * all held at once.
+ *
+ * Plugins are loaded through a detached game handle, so the game's own handle
+ * is never touched from the loader thread. Loading happens in batches no
+ * larger than the configured thread count, which caps the number of cores in
+ * use and gives cancellation points between batches.
+ */
+class BackgroundPluginLoader {
+public:
+  BackgroundPluginLoader();
+  ~BackgroundPluginLoader();
+
+  // Cancels any load in progress, then starts fully loading the given game's
+  // plugins. If maxThreads is 0, half of the available cores are used.
+  void Start(Game& game,
+             unsigned int maxThreads,
+             std::shared_ptr<EventSink> events = nullptr);
+
+  // Blocks until the batch being loaded (if any) has finished.
+  void Cancel();
+
+  bool IsRunning() const;
+
+private:
+  void Run(Game& game,
+           std::shared_ptr<GameInterface> handle,
+           std::vector<std::string> pluginNames,
+           unsigned int pluginsLoadId,
+           size_t batchSize,
+           std::shared_ptr<FormIdIndex> formIdIndex,
+           GameType gameType,
+           boost::filesystem::path dataPath,
+           std::shared_ptr<EventSink> events);
+
+  static size_t GetBatchSize(unsigned int maxThreads);
+  static void LowerThreadPriority();
+
+  std::thread thread_;
+  std::atomic<bool> cancelled_;
+  std::atomic<bool> running_;
+  std::shared_ptr<spdlog::logger> logger_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/compact_plugin.h"
+
+namespace loot {
+namespace gui {
+FullLoadData::FullLoadData() : crc(0), isValidAsLightMaster(false) {}
+
+FullLoadData::FullLoadData(const PluginInterface& plugin) :
+    crc(plugin.GetCRC()),
+    isValidAsLightMaster(plugin.IsValidAsLightMaster()) {}
+
+CompactPlugin::CompactPlugin(std::shared_ptr<const PluginInterface> header,
+                             const FullLoadData& fullLoadData,
+                             std::shared_ptr<const FormIdIndex> formIdIndex) :
+    header_(header),
+    fullLoadData_(fullLoadData),
+    formIdIndex_(formIdIndex) {}
+
+std::string CompactPlugin::GetName() const { return header_->GetName(); }
+
+std::string CompactPlugin::GetVersion() const {
+  return header_->GetVersion();
+}
+
+std::vector<std::string> CompactPlugin::GetMasters() const {
+  return header_->GetMasters();
+}
+
+std::set<Tag> CompactPlugin::GetBashTags() const {
+  return header_->GetBashTags();
+}
+
+uint32_t CompactPlugin::GetCRC() const { return fullLoadData_.crc; }
+
+bool CompactPlugin::IsMaster() const { return header_->IsMaster(); }
+
+bool CompactPlugin::IsLightMaster() const { return header_->IsLightMaster(); }
+
+bool CompactPlugin::IsValidAsLightMaster() const {
+  return fullLoadData_.isValidAsLightMaster;
+}
+
+bool CompactPlugin::IsEmpty() const { return header_->IsEmpty(); }
+
+bool CompactPlugin::LoadsArchive() const { return header_->LoadsArchive(); }
+
+bool CompactPlugin::DoFormIDsOverlap(const PluginInterface& plugin) const {
+  return formIdIndex_->DoPluginsOverlap(GetName(), plugin.GetName());
+}
+}
+}
@@ -0,0 +1,78 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_COMPACT_PLUGIN
+#define LOOT_GUI_STATE_COMPACT_PLUGIN
+
+#include <memory>
+
+#include "gui/state/form_id_index.h"
+#include "loot/api.h"
+
+namespace loot {
+namespace gui {
+// The data that a full load of a plugin gives beyond what its header does,
+// apart from its records.
+struct FullLoadData {
+  FullLoadData();
+  explicit FullLoadData(const PluginInterface& plugin);
+
+  uint32_t crc;
+  bool isValidAsLightMaster;
+};
+
+// A plugin that has been fully loaded, but only keeps what LOOT uses from
+// the full load. Its header data comes from a headers-only load of the same
+// file, and its FormIDs are looked up in the game's FormID index, so none of
+// its records are kept in memory.
+class CompactPlugin : public PluginInterface {
+public:
+  CompactPlugin(std::shared_ptr<const PluginInterface> header,
+                const FullLoadData& fullLoadData,
+                std::shared_ptr<const FormIdIndex> formIdIndex);
+
+  std::string GetName() const;
+  std::string GetVersion() const;
+  std::vector<std::string> GetMasters() const;
+  std::set<Tag> GetBashTags() const;
+  uint32_t GetCRC() const;
+
+  bool IsMaster() const;
+  bool IsLightMaster() const;
+  bool IsValidAsLightMaster() const;
+  bool IsEmpty() const;
+  bool LoadsArchive() const;
+
+  // Throws std::invalid_argument if either plugin isn't in the FormID index.
+  bool DoFormIDsOverlap(const PluginInterface& plugin) const;
+
+private:
+  const std::shared_ptr<const PluginInterface> header_;
+  const FullLoadData fullLoadData_;
+  const std::shared_ptr<const FormIdIndex> formIdIndex_;
+};
+}
+}
+
+#endif
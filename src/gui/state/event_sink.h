@@ -0,0 +1,77 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_EVENT_SINK
+#define LOOT_GUI_STATE_EVENT_SINK
+
+#include <string>
+
+namespace loot {
+struct ProgressEvent {
+  ProgressEvent() : done(0), total(0), background(false) {}
+  ProgressEvent(const std::string& phase,
+                const std::string& message,
+                size_t done = 0,
+                size_t total = 0,
+                const std::string& plugin = "",
+                bool background = false) :
+      phase(phase),
+      message(message),
+      done(done),
+      total(total),
+      plugin(plugin),
+      background(background) {}
+
+  std::string phase;
+  std::string message;
+  size_t done;
+  size_t total;
+  std::string plugin;
+
+  // Background progress is for work that the user is not waiting on.
+  bool background;
+};
+
+/**
+ * @brief An interface for pushing progress and state change notifications to
+ *        whatever is presenting LOOT's state.
+ * @details Implementations may coalesce or drop events, so only the most
+ *          recent progress event for a phase is guaranteed to be delivered,
+ *          and only once flush() has been called.
+ */
+class EventSink {
+public:
+  virtual ~EventSink() {}
+
+  virtual void sendProgress(const ProgressEvent& event) = 0;
+
+  // Notify that cached state identified by the given scope is now stale.
+  virtual void sendInvalidation(const std::string& scope) = 0;
+
+  // Deliver any coalesced events that are still pending.
+  virtual void flush() = 0;
+};
+}
+
+#endif
@@ -0,0 +1,762 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/form_id_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <future>
+#include <set>
+#include <thread>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/format.hpp>
+
+#include "gui/state/logging.h"
+#include "loot/exception/file_access_error.h"
+
+namespace fs = boost::filesystem;
+
+namespace loot {
+namespace gui {
+namespace {
+constexpr uint32_t lightMasterFlag = 0x200;
+constexpr char persistedMagic[] = "LOOTFIDX";
+// Increment whenever the persisted format or FormID resolution changes.
+constexpr uint32_t persistedVersion = 1;
+
+template<typename T>
+void Write(std::ostream& out, T value) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out.put(
+        static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+  }
+}
+
+void Write(std::ostream& out, const std::string& value) {
+  Write(out, static_cast<uint32_t>(value.size()));
+  out.write(value.data(), value.size());
+}
+
+template<typename T>
+T Read(std::istream& in) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    auto byte = in.get();
+    if (byte == std::char_traits<char>::eof())
+      throw std::runtime_error("unexpected end of file");
+    value |= static_cast<uint64_t>(byte & 0xFF) << (8 * i);
+  }
+  return static_cast<T>(value);
+}
+
+std::string ReadString(std::istream& in) {
+  auto size = Read<uint32_t>(in);
+  std::string value(size, '\0');
+  if (!in.read(&value[0], size))
+    throw std::runtime_error("unexpected end of file");
+  return value;
+}
+
+uint32_t ReadUInt32(const char* data) {
+  auto bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<uint32_t>(bytes[0]) |
+         static_cast<uint32_t>(bytes[1]) << 8 |
+         static_cast<uint32_t>(bytes[2]) << 16 |
+         static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+uint16_t ReadUInt16(const char* data) {
+  auto bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+}
+}
+
+FormIdIndex::FormIdIndex(const boost::filesystem::path& persistencePath) :
+    persistencePath_(persistencePath),
+    persistedLoaded_(false) {}
+
+bool FormIdIndex::Update(GameType gameType,
+                         const boost::filesystem::path& dataPath,
+                         const std::vector<std::string>& pluginNames,
+                         const std::atomic<bool>* cancelled) {
+  std::lock_guard<std::mutex> updateGuard(updateMutex_);
+  auto logger = getLogger();
+
+  if (!persistedLoaded_) {
+    persistedLoaded_ = true;
+    LoadPersisted();
+  }
+
+  // Work out which plugins need to be read. Plugins that have only had their
+  // modification time change can be reused if their CRC is unchanged, but
+  // that's checked later, outside the lock.
+  std::vector<Change> changes;
+  std::set<std::string> current;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& pluginName : pluginNames) {
+      auto key = boost::to_lower_copy(pluginName);
+      current.insert(key);
+
+      Change change;
+      change.entry.name = pluginName;
+      change.entry.crc = 0;
+      boost::system::error_code ec;
+      auto path = GetPluginPath(dataPath, pluginName);
+      change.entry.fileSize = fs::file_size(path, ec);
+      change.entry.modificationTime = ec ? 0 : fs::last_write_time(path, ec);
+
+      const PluginEntry* previous = nullptr;
+      auto it = plugins_.find(key);
+      if (it != plugins_.end()) {
+        previous = &it->second;
+        change.source = Change::current;
+      } else {
+        auto persisted = persisted_.find(key);
+        if (persisted != persisted_.end()) {
+          previous = &persisted->second;
+          change.source = Change::persisted;
+        }
+      }
+
+      if (previous && previous->fileSize == change.entry.fileSize) {
+        change.entry.crc = previous->crc;
+        if (previous->modificationTime == change.entry.modificationTime) {
+          if (change.source == Change::current)
+            continue;
+
+          change.action = Change::reuse;
+        } else if (previous->crc != 0) {
+          change.action = Change::checkCrc;
+        }
+      }
+
+      changes.push_back(change);
+    }
+  }
+
+  // Check CRCs and read records in parallel, outside the lock so that
+  // lookups can continue in the meantime.
+  std::vector<PluginRecords> records(changes.size());
+  size_t threadCount =
+      std::max(1u, std::min(std::thread::hardware_concurrency(),
+                            static_cast<unsigned int>(changes.size())));
+  std::vector<std::future<void>> readers;
+  for (size_t thread = 0; thread < threadCount; ++thread) {
+    readers.push_back(std::async(std::launch::async, [&, thread]() {
+      for (size_t i = thread; i < changes.size(); i += threadCount) {
+        if (cancelled && *cancelled)
+          return;
+
+        auto& change = changes[i];
+        auto path = GetPluginPath(dataPath, change.entry.name);
+        try {
+          if (change.action == Change::checkCrc) {
+            auto crc = CalculateCrc(path);
+            change.action = crc == change.entry.crc ? Change::reuse
+                                                    : Change::read;
+            change.entry.crc = crc;
+          }
+
+          if (change.action == Change::read) {
+            records[i] = ReadRecords(gameType, path, change.entry.name);
+          }
+        } catch (std::exception& e) {
+          if (logger) {
+            logger->error("Could not read the records in \"{}\": {}",
+                          change.entry.name,
+                          e.what());
+          }
+          // Index the plugin as having no records for now, but mark it as
+          // unread so that the next update tries reading it again.
+          change.action = Change::read;
+          change.entry.crc = 0;
+          change.entry.modificationTime = 0;
+          records[i] = PluginRecords();
+        }
+      }
+    }));
+  }
+  for (auto& reader : readers) {
+    reader.get();
+  }
+
+  if (cancelled && *cancelled) {
+    if (logger) {
+      logger->debug("FormID index update cancelled.");
+    }
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  bool changed = !changes.empty();
+  for (auto it = plugins_.begin(); it != plugins_.end();) {
+    if (current.count(it->first) == 0) {
+      RemovePlugin(it->second);
+      it = plugins_.erase(it);
+      changed = true;
+    } else {
+      ++it;
+    }
+  }
+
+  size_t readCount = 0;
+  for (size_t i = 0; i < changes.size(); ++i) {
+    auto& change = changes[i];
+    auto& entry = change.entry;
+    auto key = boost::to_lower_copy(entry.name);
+
+    if (change.action == Change::reuse && change.source == Change::current) {
+      plugins_.at(key).modificationTime = entry.modificationTime;
+      continue;
+    }
+
+    auto it = plugins_.find(key);
+    if (it != plugins_.end()) {
+      RemovePlugin(it->second);
+      plugins_.erase(it);
+    }
+
+    if (change.action == Change::reuse) {
+      entry.formIds = std::move(persisted_.at(key).formIds);
+    } else {
+      ++readCount;
+      entry.formIds.reserve(records[i].formIds.size());
+      for (const auto formId : records[i].formIds) {
+        entry.formIds.push_back(
+            ResolveFormId(entry.name, records[i], formId));
+      }
+      std::sort(entry.formIds.begin(), entry.formIds.end());
+      entry.formIds.erase(
+          std::unique(entry.formIds.begin(), entry.formIds.end()),
+          entry.formIds.end());
+    }
+    persisted_.erase(key);
+
+    AddPlugin(entry);
+    plugins_.emplace(key, std::move(entry));
+  }
+
+  if (logger) {
+    logger->debug("Updated FormID index: read {} plugins, {} indexed.",
+                  readCount,
+                  plugins_.size());
+  }
+
+  if (changed)
+    SavePersisted();
+
+  return changed;
+}
+
+void FormIdIndex::SetCrcs(const std::map<std::string, uint32_t>& crcs) {
+  std::lock_guard<std::mutex> updateGuard(updateMutex_);
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  bool changed = false;
+  for (const auto& crc : crcs) {
+    auto it = plugins_.find(boost::to_lower_copy(crc.first));
+    if (it != plugins_.end() && crc.second != 0 &&
+        it->second.crc != crc.second) {
+      it->second.crc = crc.second;
+      changed = true;
+    }
+  }
+
+  if (changed)
+    SavePersisted();
+}
+
+void FormIdIndex::Clear() {
+  std::lock_guard<std::mutex> updateGuard(updateMutex_);
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  plugins_.clear();
+  persisted_.clear();
+  persistedLoaded_ = false;
+  pluginNames_.clear();
+  freePluginIds_.clear();
+  originIds_.clear();
+  index_.clear();
+}
+
+bool FormIdIndex::IsEmpty() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return plugins_.empty();
+}
+
+std::vector<std::string> FormIdIndex::GetOverlappingPlugins(
+    const std::string& pluginName) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto it = plugins_.find(boost::to_lower_copy(pluginName));
+  if (it == plugins_.end())
+    return std::vector<std::string>();
+
+  std::set<uint32_t> overlapping;
+  for (const auto formId : it->second.formIds) {
+    auto entry = index_.find(formId);
+    if (entry == index_.end())
+      continue;
+
+    for (const auto pluginId : entry->second) {
+      if (pluginId != it->second.id)
+        overlapping.insert(pluginId);
+    }
+  }
+
+  std::vector<std::string> names;
+  for (const auto pluginId : overlapping) {
+    names.push_back(pluginNames_[pluginId]);
+  }
+
+  return names;
+}
+
+size_t FormIdIndex::GetFormIdCount(const std::string& pluginName) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto it = plugins_.find(boost::to_lower_copy(pluginName));
+  if (it == plugins_.end())
+    return 0;
+
+  return it->second.formIds.size();
+}
+
+bool FormIdIndex::DoPluginsOverlap(const std::string& firstPluginName,
+                                   const std::string& secondPluginName) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto first = plugins_.find(boost::to_lower_copy(firstPluginName));
+  auto second = plugins_.find(boost::to_lower_copy(secondPluginName));
+  if (first == plugins_.end() || second == plugins_.end())
+    throw std::invalid_argument("Cannot check if \"" + firstPluginName +
+                                "\" and \"" + secondPluginName +
+                                "\" overlap, as they are not both indexed");
+
+  // Look up the FormIDs of whichever plugin has fewer, and check if the other
+  // plugin is among the plugins that contain them.
+  const PluginEntry* fewer = &first->second;
+  const PluginEntry* more = &second->second;
+  if (fewer->formIds.size() > more->formIds.size())
+    std::swap(fewer, more);
+
+  for (const auto formId : fewer->formIds) {
+    auto entry = index_.find(formId);
+    if (entry != index_.end() && std::binary_search(entry->second.begin(),
+                                                    entry->second.end(),
+                                                    more->id))
+      return true;
+  }
+
+  return false;
+}
+
+FormIdIndex::ConflictMatrix FormIdIndex::GetConflictMatrix(
+    ProgressCallback progress,
+    const std::atomic<bool>* cancelled) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  // Each thread counts pairs within its own share of the index's buckets, so
+  // no synchronisation is needed until the counts are merged. Pairs are keyed
+  // by their two plugin IDs, lower first.
+  const size_t bucketCount = index_.bucket_count();
+  const size_t threadCount =
+      std::max(1u, std::min(std::thread::hardware_concurrency(),
+                            static_cast<unsigned int>(bucketCount)));
+  std::atomic<size_t> bucketsDone(0);
+  std::vector<std::unordered_map<uint64_t, uint32_t>> pairCounts(threadCount);
+  std::vector<std::future<void>> counters;
+  for (size_t thread = 0; thread < threadCount; ++thread) {
+    counters.push_back(std::async(std::launch::async, [&, thread]() {
+      auto& counts = pairCounts[thread];
+      for (size_t bucket = thread; bucket < bucketCount;
+           bucket += threadCount) {
+        if (cancelled && *cancelled)
+          return;
+
+        for (auto it = index_.begin(bucket); it != index_.end(bucket); ++it) {
+          const auto& pluginIds = it->second;
+          for (size_t i = 0; i < pluginIds.size(); ++i) {
+            for (size_t j = i + 1; j < pluginIds.size(); ++j) {
+              ++counts[static_cast<uint64_t>(pluginIds[i]) << 32 |
+                       pluginIds[j]];
+            }
+          }
+        }
+
+        auto done = ++bucketsDone;
+        if (thread == 0 && progress)
+          progress(done, bucketCount);
+      }
+    }));
+  }
+  for (auto& counter : counters) {
+    counter.get();
+  }
+
+  ConflictMatrix matrix;
+  if (cancelled && *cancelled)
+    return matrix;
+
+  // Removed plugins can leave gaps in the plugin IDs until they are reused,
+  // so map the live ones onto matrix indices.
+  std::vector<uint32_t> matrixIndices(pluginNames_.size());
+  for (const auto& plugin : plugins_) {
+    matrixIndices[plugin.second.id] =
+        static_cast<uint32_t>(matrix.plugins.size());
+    matrix.plugins.push_back(plugin.second.name);
+  }
+
+  matrix.conflicts.resize(matrix.plugins.size());
+  std::unordered_map<uint64_t, uint32_t> totals;
+  for (const auto& counts : pairCounts) {
+    for (const auto& count : counts) {
+      totals[count.first] += count.second;
+    }
+  }
+  for (const auto& total : totals) {
+    auto first = matrixIndices[total.first >> 32];
+    auto second = matrixIndices[total.first & 0xFFFFFFFF];
+    matrix.conflicts[first].emplace_back(second, total.second);
+    matrix.conflicts[second].emplace_back(first, total.second);
+  }
+  for (auto& conflicts : matrix.conflicts) {
+    std::sort(conflicts.begin(), conflicts.end());
+  }
+
+  return matrix;
+}
+
+size_t FormIdIndex::EstimateMemoryUsage() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  // Each index entry holds its key, a vector and at least one plugin ID, and
+  // the hash table adds roughly another pointer and bucket per entry.
+  size_t estimate = index_.size() * (sizeof(uint64_t) +
+                                     sizeof(PluginIds) +
+                                     sizeof(uint32_t) + 2 * sizeof(void*));
+  for (const auto& plugin : plugins_) {
+    estimate += plugin.second.formIds.capacity() * sizeof(uint64_t);
+  }
+
+  return estimate;
+}
+
+void FormIdIndex::LoadPersisted() {
+  if (persistencePath_.empty() || !fs::exists(persistencePath_))
+    return;
+
+  auto logger = getLogger();
+  std::lock_guard<std::mutex> guard(mutex_);
+  try {
+    fs::ifstream in(persistencePath_, std::ios::binary);
+    std::string magic(sizeof(persistedMagic) - 1, '\0');
+    if (!in.read(&magic[0], magic.size()) || magic != persistedMagic ||
+        Read<uint32_t>(in) != persistedVersion) {
+      if (logger) {
+        logger->info("Ignoring FormID index in an unrecognised format: {}",
+                     persistencePath_.string());
+      }
+      return;
+    }
+
+    // The stored origin IDs have to be mapped onto this index's.
+    std::vector<uint32_t> originIds(Read<uint32_t>(in));
+    for (auto& originId : originIds) {
+      auto name = ReadString(in);
+      auto it =
+          originIds_.emplace(name, static_cast<uint32_t>(originIds_.size()))
+              .first;
+      originId = it->second;
+    }
+
+    auto pluginCount = Read<uint32_t>(in);
+    for (uint32_t i = 0; i < pluginCount; ++i) {
+      PluginEntry entry;
+      entry.name = ReadString(in);
+      entry.id = 0;
+      entry.fileSize = Read<uint64_t>(in);
+      entry.modificationTime = Read<int64_t>(in);
+      entry.crc = Read<uint32_t>(in);
+      entry.formIds.resize(Read<uint64_t>(in));
+      for (auto& formId : entry.formIds) {
+        auto stored = Read<uint64_t>(in);
+        formId = static_cast<uint64_t>(originIds.at(stored >> 32)) << 32 |
+                 (stored & 0xFFFFFFFF);
+      }
+      std::sort(entry.formIds.begin(), entry.formIds.end());
+
+      auto key = boost::to_lower_copy(entry.name);
+      persisted_[key] = std::move(entry);
+    }
+
+    if (logger) {
+      logger->debug("Loaded stored FormIDs for {} plugins.", persisted_.size());
+    }
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("Could not load the stored FormID index from {}: {}",
+                    persistencePath_.string(),
+                    e.what());
+    }
+    persisted_.clear();
+  }
+}
+
+void FormIdIndex::SavePersisted() const {
+  if (persistencePath_.empty())
+    return;
+
+  auto logger = getLogger();
+  try {
+    // Write to a temporary file first so that an interrupted save doesn't
+    // leave a truncated index behind.
+    auto tempPath = persistencePath_;
+    tempPath += ".tmp";
+    {
+      fs::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+      out.write(persistedMagic, sizeof(persistedMagic) - 1);
+      Write(out, persistedVersion);
+
+      std::vector<const std::string*> origins(originIds_.size());
+      for (const auto& origin : originIds_) {
+        origins[origin.second] = &origin.first;
+      }
+      Write(out, static_cast<uint32_t>(origins.size()));
+      for (const auto origin : origins) {
+        Write(out, *origin);
+      }
+
+      // Plugins that couldn't be read aren't stored, so that they're read
+      // again in later sessions.
+      auto isUnread =
+          [](const std::pair<const std::string, PluginEntry>& plugin) {
+            return plugin.second.modificationTime == 0;
+          };
+      Write(out,
+            static_cast<uint32_t>(
+                plugins_.size() -
+                std::count_if(plugins_.begin(), plugins_.end(), isUnread)));
+      for (const auto& plugin : plugins_) {
+        if (isUnread(plugin))
+          continue;
+
+        const auto& entry = plugin.second;
+        Write(out, entry.name);
+        Write(out, static_cast<uint64_t>(entry.fileSize));
+        Write(out, static_cast<int64_t>(entry.modificationTime));
+        Write(out, entry.crc);
+        Write(out, static_cast<uint64_t>(entry.formIds.size()));
+        for (const auto formId : entry.formIds) {
+          Write(out, formId);
+        }
+      }
+
+      if (!out.good())
+        throw std::runtime_error("write failed");
+    }
+    fs::rename(tempPath, persistencePath_);
+  } catch (std::exception& e) {
+    if (logger) {
+      logger->error("Could not store the FormID index at {}: {}",
+                    persistencePath_.string(),
+                    e.what());
+    }
+  }
+}
+
+uint32_t FormIdIndex::CalculateCrc(const boost::filesystem::path& pluginPath) {
+  fs::ifstream in(pluginPath, std::ios::binary);
+  if (!in.good()) {
+    throw FileAccessError(
+        (boost::format("Couldn't open %1%") % pluginPath.string()).str());
+  }
+
+  boost::crc_32_type crc;
+  std::vector<char> buffer(1024 * 1024);
+  while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+    crc.process_bytes(buffer.data(), static_cast<size_t>(in.gcount()));
+  }
+
+  return crc.checksum();
+}
+
+FormIdIndex::PluginRecords FormIdIndex::ReadRecords(
+    GameType gameType,
+    const boost::filesystem::path& pluginPath,
+    const std::string& pluginName) {
+  // Oblivion's record and group headers are 4 bytes shorter than the later
+  // games'.
+  const size_t headerSize = gameType == GameType::tes4 ? 20 : 24;
+
+  fs::ifstream in(pluginPath, std::ios::binary);
+  if (!in.good()) {
+    throw FileAccessError(
+        (boost::format("Couldn't open %1%") % pluginPath.string()).str());
+  }
+  in.seekg(0, std::ios::end);
+  const uint64_t fileSize = in.tellg();
+  in.seekg(0, std::ios::beg);
+
+  // The first record is the plugin header, which lists its masters.
+  std::array<char, 24> header;
+  if (!in.read(header.data(), headerSize) ||
+      std::string(header.data(), 4) != "TES4") {
+    throw FileAccessError((boost::format("%1% is not a valid plugin") %
+                           pluginPath.filename().string())
+                              .str());
+  }
+
+  PluginRecords records;
+  const uint32_t headerDataSize = ReadUInt32(header.data() + 4);
+  const uint32_t headerFlags = ReadUInt32(header.data() + 8);
+  records.isLightMaster =
+      (gameType == GameType::fo4 || gameType == GameType::tes5se) &&
+      ((headerFlags & lightMasterFlag) != 0 ||
+       boost::iends_with(pluginName, ".esl"));
+
+  std::vector<char> headerData(headerDataSize);
+  if (!in.read(headerData.data(), headerDataSize)) {
+    throw FileAccessError((boost::format("%1% is truncated") %
+                           pluginPath.filename().string())
+                              .str());
+  }
+
+  uint32_t nextSubrecordSize = 0;
+  for (size_t pos = 0; pos + 6 <= headerData.size();) {
+    std::string type(headerData.data() + pos, 4);
+    uint32_t size = ReadUInt16(headerData.data() + pos + 4);
+    pos += 6;
+    if (nextSubrecordSize != 0) {
+      size = nextSubrecordSize;
+      nextSubrecordSize = 0;
+    }
+    if (pos + size > headerData.size())
+      break;
+
+    if (type == "XXXX" && size == 4) {
+      nextSubrecordSize = ReadUInt32(headerData.data() + pos);
+    } else if (type == "MAST") {
+      records.masters.push_back(
+          std::string(headerData.data() + pos,
+                      strnlen(headerData.data() + pos, size)));
+    }
+    pos += size;
+  }
+
+  // Walk the rest of the file one header at a time. Groups are entered by
+  // skipping only their header, records by skipping their header and data.
+  uint64_t pos = headerSize + headerDataSize;
+  while (pos + headerSize <= fileSize) {
+    in.seekg(pos);
+    if (!in.read(header.data(), headerSize))
+      break;
+
+    const uint32_t size = ReadUInt32(header.data() + 4);
+    if (std::string(header.data(), 4) == "GRUP") {
+      pos += headerSize;
+    } else {
+      records.formIds.push_back(ReadUInt32(header.data() + 12));
+      pos += headerSize + size;
+    }
+  }
+
+  return records;
+}
+
+fs::path FormIdIndex::GetPluginPath(const boost::filesystem::path& dataPath,
+                                    const std::string& pluginName) {
+  auto path = dataPath / pluginName;
+  if (!fs::exists(path) && fs::exists(path.string() + ".ghost"))
+    return path.string() + ".ghost";
+
+  return path;
+}
+
+uint64_t FormIdIndex::ResolveFormId(const std::string& pluginName,
+                                    const PluginRecords& records,
+                                    uint32_t formId) {
+  // The top byte of a FormID indexes into the plugin's masters, with any
+  // higher index referring to the plugin itself.
+  size_t modIndex = formId >> 24;
+  const std::string& origin =
+      modIndex < records.masters.size() ? records.masters[modIndex] : pluginName;
+  uint32_t objectIndex = formId & 0x00FFFFFF;
+  if (modIndex >= records.masters.size() && records.isLightMaster)
+    objectIndex &= 0x00000FFF;
+
+  auto key = boost::to_lower_copy(origin);
+  auto it = originIds_.find(key);
+  if (it == originIds_.end()) {
+    it = originIds_.emplace(key, static_cast<uint32_t>(originIds_.size()))
+             .first;
+  }
+
+  return static_cast<uint64_t>(it->second) << 32 | objectIndex;
+}
+
+void FormIdIndex::AddPlugin(PluginEntry& entry) {
+  if (freePluginIds_.empty()) {
+    entry.id = static_cast<uint32_t>(pluginNames_.size());
+    pluginNames_.push_back(entry.name);
+  } else {
+    entry.id = freePluginIds_.back();
+    freePluginIds_.pop_back();
+    pluginNames_[entry.id] = entry.name;
+  }
+
+  // A reused ID may be lower than IDs already in an entry, so insert it in
+  // order. A new ID is the highest, so is appended.
+  for (const auto formId : entry.formIds) {
+    auto& pluginIds = index_[formId];
+    pluginIds.insert(
+        std::lower_bound(pluginIds.begin(), pluginIds.end(), entry.id),
+        entry.id);
+  }
+}
+
+void FormIdIndex::RemovePlugin(const PluginEntry& entry) {
+  for (const auto formId : entry.formIds) {
+    auto it = index_.find(formId);
+    if (it == index_.end())
+      continue;
+
+    auto& pluginIds = it->second;
+    auto pos = std::lower_bound(pluginIds.begin(), pluginIds.end(), entry.id);
+    if (pos != pluginIds.end() && *pos == entry.id)
+      pluginIds.erase(pos);
+    if (pluginIds.empty())
+      index_.erase(it);
+  }
+  pluginNames_[entry.id].clear();
+  freePluginIds_.push_back(entry.id);
+}
+}
+}
@@ -0,0 +1,198 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_FORM_ID_INDEX
+#define LOOT_GUI_STATE_FORM_ID_INDEX
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gui/state/memory_usage.h"
+#include "loot/enum/game_type.h"
+
+namespace loot {
+namespace gui {
+/**
+ * An inverted index from FormIDs to the plugins that contain records for
+ * them, so that finding the plugins that a plugin conflicts with only needs
+ * to look up that plugin's own FormIDs, instead of comparing its records
+ * with those of every other plugin.
+ *
+ * FormIDs are read from the record headers in the plugin files, skipping
+ * record data, so the index doesn't depend on the LOOT API having fully
+ * loaded the plugins. FormIDs are resolved against each plugin's masters, so
+ * a plugin's override records share index entries with the originals.
+ *
+ * If given a persistence path, the index is stored there whenever it changes,
+ * and reused by the first update in a later session. A stored plugin is
+ * reused if its size and modification time are unchanged, or if its size is
+ * unchanged and its CRC matches the one stored. Plugins that can't be read
+ * are indexed as having no FormIDs, but aren't stored, and are read again by
+ * the next update.
+ */
+class FormIdIndex {
+public:
+  struct ConflictMatrix {
+    std::vector<std::string> plugins;
+    // For each plugin, the indices of the plugins it conflicts with, paired
+    // with how many FormIDs the two share, in ascending order of index.
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> conflicts;
+  };
+
+  typedef std::function<void(size_t done, size_t total)> ProgressCallback;
+
+  explicit FormIdIndex(
+      const boost::filesystem::path& persistencePath = "");
+
+  // Brings the index up to date with the given plugins. Only plugins that are
+  // new, or that have changed since they were last read, are read. Plugins
+  // that are no longer given are removed. If cancelled becomes true while
+  // plugins are being read, the index is left unchanged. Returns true if the
+  // index changed.
+  bool Update(GameType gameType,
+              const boost::filesystem::path& dataPath,
+              const std::vector<std::string>& pluginNames,
+              const std::atomic<bool>* cancelled = nullptr);
+
+  // Records the CRCs of fully loaded plugins, so that later updates can
+  // reuse plugins whose modification time changed but content didn't.
+  void SetCrcs(const std::map<std::string, uint32_t>& crcs);
+
+  // Empties the index in memory, leaving the stored copy alone.
+  void Clear();
+
+  bool IsEmpty() const;
+
+  // Returns the names of the other plugins that contain records for any of
+  // the given plugin's FormIDs.
+  std::vector<std::string> GetOverlappingPlugins(
+      const std::string& pluginName) const;
+
+  // Returns 0 if the plugin isn't indexed.
+  size_t GetFormIdCount(const std::string& pluginName) const;
+
+  // Checks if the two plugins contain records for any of the same FormIDs.
+  // Throws std::invalid_argument if either plugin isn't indexed.
+  bool DoPluginsOverlap(const std::string& firstPluginName,
+                        const std::string& secondPluginName) const;
+
+  // Finds every pair of indexed plugins that share FormIDs, counting the
+  // FormIDs they share. The index is split between threads, and progress is
+  // reported from one of them. If cancelled becomes true, an empty matrix is
+  // returned.
+  ConflictMatrix GetConflictMatrix(
+      ProgressCallback progress = ProgressCallback(),
+      const std::atomic<bool>* cancelled = nullptr) const;
+
+  size_t EstimateMemoryUsage() const;
+
+private:
+  template <typename T>
+  using Allocator = CountingAllocator<T, MemorySubsystem::formIdIndex>;
+  typedef std::vector<uint32_t, Allocator<uint32_t>> PluginIds;
+
+  struct PluginRecords {
+    std::vector<std::string> masters;
+    bool isLightMaster;
+    std::vector<uint32_t> formIds;
+  };
+
+  struct PluginEntry {
+    std::string name;
+    uint32_t id;
+    uintmax_t fileSize;
+    std::time_t modificationTime;
+    // 0 if unknown.
+    uint32_t crc;
+    // Resolved FormIDs, sorted.
+    std::vector<uint64_t, Allocator<uint64_t>> formIds;
+  };
+
+  struct Change {
+    enum Source { none, current, persisted };
+    enum Action { read, reuse, checkCrc };
+
+    Change() : source(none), action(read) {}
+
+    PluginEntry entry;
+    Source source;
+    Action action;
+  };
+
+  static uint32_t CalculateCrc(const boost::filesystem::path& pluginPath);
+  static PluginRecords ReadRecords(GameType gameType,
+                                   const boost::filesystem::path& pluginPath,
+                                   const std::string& pluginName);
+  static boost::filesystem::path GetPluginPath(
+      const boost::filesystem::path& dataPath,
+      const std::string& pluginName);
+
+  uint64_t ResolveFormId(const std::string& pluginName,
+                         const PluginRecords& records,
+                         uint32_t formId);
+  void AddPlugin(PluginEntry& entry);
+  void RemovePlugin(const PluginEntry& entry);
+  void LoadPersisted();
+  // Must be called with mutex_ held.
+  void SavePersisted() const;
+
+  const boost::filesystem::path persistencePath_;
+  bool persistedLoaded_;
+  // Stored plugins that haven't been matched to an installed plugin yet,
+  // keyed by lowercased plugin name.
+  std::map<std::string, PluginEntry> persisted_;
+
+  // Keyed by lowercased plugin name.
+  std::map<std::string, PluginEntry> plugins_;
+  // Indexed by plugin ID. IDs are reused once their plugins are removed, so
+  // that re-reading plugins in a long session doesn't keep adding IDs.
+  std::vector<std::string> pluginNames_;
+  std::vector<uint32_t> freePluginIds_;
+  // Maps lowercased plugin names to the IDs used in resolved FormIDs.
+  std::unordered_map<std::string, uint32_t> originIds_;
+  // Maps resolved FormIDs to the sorted IDs of plugins that contain them.
+  std::unordered_map<uint64_t,
+                     PluginIds,
+                     std::hash<uint64_t>,
+                     std::equal_to<uint64_t>,
+                     Allocator<std::pair<const uint64_t, PluginIds>>>
+      index_;
+
+  mutable std::mutex mutex_;
+  // Held for the duration of an update, so that updates don't interleave.
+  std::mutex updateMutex_;
+};
+}
+}
+
+#endif
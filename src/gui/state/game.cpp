@@ -26,15 +26,22 @@
 
 #include <algorithm>
 #include <cmath>
+#include <future>
+#include <sstream>
 #include <thread>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
 #include "gui/helpers.h"
 #include "gui/state/game_detection_error.h"
 #include "gui/state/logging.h"
+#include "gui/state/loot_paths.h"
+#include "gui/state/performance_stats.h"
 #include "loot/exception/file_access_error.h"
 
 #ifdef _WIN32
@@ -67,44 +74,120 @@ bool hasPluginFileExtension(const std::string& filename) {
          boost::iends_with(filename, ".esl");
 }
 
+// Remembers paths that were found not to exist, so that games that share
+// candidate install paths don't probe the same missing paths repeatedly.
+class MissingPathCache {
+public:
+  bool Exists(const fs::path& path) {
+    {
+      lock_guard<mutex> guard(mutex_);
+      if (missingPaths_.count(path) != 0)
+        return false;
+    }
+
+    if (fs::exists(path))
+      return true;
+
+    lock_guard<mutex> guard(mutex_);
+    missingPaths_.insert(path);
+    return false;
+  }
+
+private:
+  std::set<fs::path> missingPaths_;
+  mutex mutex_;
+};
+
+std::atomic<unsigned int> Game::nextMetadataGeneration_(0);
+
 Game::Game(const GameSettings& gameSettings,
            const boost::filesystem::path& lootDataPath,
-           const boost::filesystem::path& localDataPath) :
+           const boost::filesystem::path& localDataPath,
+           bool detectGamePath) :
     GameSettings(gameSettings),
     lootDataPath_(lootDataPath),
+    localDataPath_(localDataPath),
+    metadataGeneration_(
+        std::make_shared<std::atomic<unsigned int>>(++nextMetadataGeneration_)),
+    formIdIndex_(std::make_shared<FormIdIndex>(
+        lootDataPath.empty()
+            ? fs::path()
+            : lootDataPath / gameSettings.FolderName() / "formids.bin")),
     pluginsFullyLoaded_(false),
+    pluginsLoadId_(0),
+    loadedInstallFingerprint_(0),
+    profileDataPath_(lootDataPath / gameSettings.FolderName()),
+    sortResultPath_(lootDataPath.empty() ? fs::path()
+                                         : profileDataPath_ / "sorted.txt"),
+    sortResultLoaded_(false),
     loadOrderSortCount_(0),
-    logger_(getLogger()) {
-  SetGamePath(DetectGamePath(*this));
+    logger_(getLogger()),
+    snapshot_(std::make_shared<GameSnapshot>()),
+    snapshotVersion_(0) {
+  if (detectGamePath)
+    SetGamePath(DetectGamePath(*this));
 
   if (GamePath().empty()) {
     throw GameDetectionError("Game path could not be detected.");
   }
-
-  gameHandle_ =
-      CreateGameHandle(Type(), GamePath().string(), localDataPath.string());
-  gameHandle_->IdentifyMainMasterFile(Master());
 }
 
 Game::Game(const Game& game) :
     GameSettings(game),
     lootDataPath_(game.lootDataPath_),
-    gameHandle_(game.gameHandle_),
+    localDataPath_(game.localDataPath_),
+    gameHandle_(game.GetExistingGameHandle()),
+    metadataGeneration_(game.metadataGeneration_),
+    formIdIndex_(game.formIdIndex_),
     pluginsFullyLoaded_(game.pluginsFullyLoaded_),
+    pluginsLoadId_(game.pluginsLoadId_),
+    adoptedPlugins_(game.adoptedPlugins_),
+    loadedInstallFingerprint_(game.loadedInstallFingerprint_),
+    profileDataPath_(game.profileDataPath_),
+    sortResultPath_(game.sortResultPath_),
+    sortResultLoaded_(false),
+    violationsKey_(game.violationsKey_),
+    violations_(game.violations_),
+    derivedDataKey_(game.derivedDataKey_),
+    derivedData_(game.derivedData_),
     messages_(game.messages_),
     loadOrderSortCount_(0),
-    logger_(getLogger()) {}
+    logger_(getLogger()),
+    snapshot_(game.GetSnapshot()),
+    snapshotVersion_(snapshot_->GetVersion()) {}
 
 Game& Game::operator=(const Game& game) {
   if (&game != this) {
     GameSettings::operator=(game);
 
     lootDataPath_ = game.lootDataPath_;
-    gameHandle_ = game.gameHandle_;
+    localDataPath_ = game.localDataPath_;
+    auto gameHandle = game.GetExistingGameHandle();
+    {
+      lock_guard<mutex> guard(gameHandleMutex_);
+      gameHandle_ = gameHandle;
+    }
+    metadataGeneration_ = game.metadataGeneration_;
+    formIdIndex_ = game.formIdIndex_;
     pluginsFullyLoaded_ = game.pluginsFullyLoaded_;
+    pluginsLoadId_ = game.pluginsLoadId_;
+    adoptedPlugins_ = game.adoptedPlugins_;
+    loadedInstallFingerprint_ = game.loadedInstallFingerprint_;
+    profileDataPath_ = game.profileDataPath_;
+    sortResultPath_ = game.sortResultPath_;
+    // The stored sort result is reloaded from the file it's saved to.
+    sortResultLoaded_ = false;
+    sortResultFingerprints_.clear();
+    sortResult_.clear();
+    violationsKey_ = game.violationsKey_;
+    violations_ = game.violations_;
+    derivedDataKey_ = game.derivedDataKey_;
+    derivedData_ = game.derivedData_;
     messages_ = game.messages_;
     loadOrderSortCount_ = game.loadOrderSortCount_;
     logger_ = game.logger_;
+    std::atomic_store(&snapshot_, game.GetSnapshot());
+    snapshotVersion_ = snapshot_->GetVersion();
   }
 
   return *this;
@@ -116,6 +199,46 @@ bool Game::IsInstalled(const GameSettings& gameSettings) {
   return !gamePath.empty();
 }
 
+std::vector<boost::filesystem::path> Game::DetectGamePaths(
+    const std::vector<GameSettings>& gameSettings) {
+  // Detection is mostly waiting on the filesystem and registry, so check
+  // every game at once.
+  MissingPathCache missingPaths;
+  vector<std::future<fs::path>> detections;
+  for (const auto& settings : gameSettings) {
+    detections.push_back(
+        std::async(std::launch::async, [&settings, &missingPaths]() {
+          return DetectGamePath(settings, missingPaths);
+        }));
+  }
+
+  vector<fs::path> gamePaths;
+  for (auto& detection : detections) {
+    gamePaths.push_back(detection.get());
+  }
+
+  return gamePaths;
+}
+
+Game Game::CreateProfile(const boost::filesystem::path& localDataPath) const {
+  // The profile is of the same install, so its path is already known.
+  Game profile(*this, lootDataPath_, localDataPath, false);
+
+  // Profiles share the masterlist and userlist, but each keeps its own load
+  // order backups and sort result.
+  if (!lootDataPath_.empty()) {
+    profile.profileDataPath_ =
+        lootDataPath_ / FolderName() / "profiles" /
+        (boost::format("%016x") %
+         boost::hash<std::string>()(localDataPath.string()))
+            .str();
+    profile.sortResultPath_ = profile.profileDataPath_ / "sorted.txt";
+  }
+  profile.formIdIndex_ = formIdIndex_;
+
+  return profile;
+}
+
 void Game::Init() {
   if (logger_) {
     logger_->info("Initialising filesystem-related data for game: {}", Name());
@@ -124,8 +247,8 @@ void Game::Init() {
   if (!lootDataPath_.empty()) {
     // Make sure that the LOOT game path exists.
     try {
-      if (!fs::exists(lootDataPath_ / FolderName()))
-        fs::create_directories(lootDataPath_ / FolderName());
+      if (!fs::exists(profileDataPath_))
+        fs::create_directories(profileDataPath_);
     } catch (fs::filesystem_error& e) {
       throw FileAccessError(
           (boost::format(
@@ -134,15 +257,47 @@ void Game::Init() {
               .str());
     }
   }
+
+  // Games get initialised when they're selected, so this is when the game
+  // handle is first needed.
+  GetGameHandle();
 }
 
 std::shared_ptr<const PluginInterface> Game::GetPlugin(
     const std::string& name) const {
-  return gameHandle_->GetPlugin(name);
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    auto it = adoptedPlugins_.find(boost::to_lower_copy(name));
+    if (it != adoptedPlugins_.end()) {
+      return it->second;
+    }
+  }
+
+  return GetGameHandle()->GetPlugin(name);
 }
 
 std::set<std::shared_ptr<const PluginInterface>> Game::GetPlugins() const {
-  return gameHandle_->GetLoadedPlugins();
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    if (!adoptedPlugins_.empty()) {
+      std::set<std::shared_ptr<const PluginInterface>> plugins;
+      for (const auto& plugin : adoptedPlugins_) {
+        plugins.insert(plugin.second);
+      }
+
+      return plugins;
+    }
+  }
+
+  // A game that has no handle yet has no loaded plugins, and reading them
+  // shouldn't be what creates its handle.
+  auto gameHandle = GetExistingGameHandle();
+  if (!gameHandle)
+    return std::set<std::shared_ptr<const PluginInterface>>();
+
+  return gameHandle->GetLoadedPlugins();
 }
 
 std::vector<Message> Game::CheckInstallValidity(
@@ -268,7 +423,8 @@ void Game::RedatePlugins() {
     return;
   }
 
-  vector<string> loadorder = gameHandle_->GetLoadOrder();
+  bool wasCurrent = IsLoadedStateCurrent();
+  vector<string> loadorder = GetGameHandle()->GetLoadOrder();
   if (!loadorder.empty()) {
     time_t lastTime = 0;
     for (const auto& pluginName : loadorder) {
@@ -306,15 +462,368 @@ void Game::RedatePlugins() {
       }
     }
   }
+
+  // Redating doesn't change the loaded plugins.
+  if (wasCurrent)
+    StoreInstallFingerprint(GetInstallFingerprint());
 }
 
 void Game::LoadAllInstalledPlugins(bool headersOnly) {
-  gameHandle_->LoadPlugins(GetInstalledPluginNames(), headersOnly);
+  // Get the fingerprint first so that any changes made during loading are
+  // picked up next time.
+  auto fingerprint = GetInstallFingerprint();
+
+  {
+    PhaseTimer timer(headersOnly ? "loadPluginHeaders" : "loadPlugins");
+    GetGameHandle()->LoadPlugins(GetInstalledPluginNames(), headersOnly);
+  }
+  StoreInstallFingerprint(fingerprint);
+
+  {
+    lock_guard<mutex> guard(mutex_);
+    pluginsFullyLoaded_ = !headersOnly;
+    adoptedPlugins_.clear();
+    ++pluginsLoadId_;
+  }
 
-  pluginsFullyLoaded_ = !headersOnly;
+  if (!headersOnly)
+    CompactLoadedPlugins();
+
+  PublishSnapshot();
+}
+
+bool Game::ArePluginsFullyLoaded() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return pluginsFullyLoaded_;
+}
+
+unsigned int Game::GetPluginsLoadId() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return pluginsLoadId_;
+}
+
+void Game::ShareLoadedPlugins(const Game& game) {
+  if (DataPath() != game.DataPath()) {
+    throw std::invalid_argument(
+        "Cannot share plugins between games with different data paths");
+  }
+
+  auto plugins = game.GetPlugins();
+  ShareLoadedPlugins(
+      std::vector<std::shared_ptr<const PluginInterface>>(plugins.begin(),
+                                                          plugins.end()),
+      game.ArePluginsFullyLoaded());
+}
+
+void Game::ShareLoadedPlugins(
+    const std::vector<std::shared_ptr<const PluginInterface>>& plugins,
+    bool pluginsFullyLoaded) {
+  StoreInstallFingerprint(GetInstallFingerprint());
+
+  {
+    lock_guard<mutex> guard(mutex_);
+    adoptedPlugins_.clear();
+    for (const auto& plugin : plugins) {
+      adoptedPlugins_.emplace(boost::to_lower_copy(plugin->GetName()), plugin);
+    }
+    pluginsFullyLoaded_ = pluginsFullyLoaded;
+    ++pluginsLoadId_;
+  }
+
+  PublishSnapshot();
 }
 
-bool Game::ArePluginsFullyLoaded() const { return pluginsFullyLoaded_; }
+bool Game::AdoptFullLoadData(const std::map<std::string, FullLoadData>& data,
+                             unsigned int pluginsLoadId) {
+  auto headers = GetPlugins();
+
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    if (pluginsLoadId != pluginsLoadId_) {
+      if (logger_) {
+        logger_->debug("Discarding fully loaded plugin data as the installed "
+                       "plugins have since been reloaded.");
+      }
+      return false;
+    }
+
+    AdoptCompactPlugins(headers, data);
+  }
+
+  PublishSnapshot();
+
+  return true;
+}
+
+void Game::CompactLoadedPlugins() {
+  PhaseTimer timer("compactPlugins");
+  auto gameHandle = GetGameHandle();
+
+  std::map<std::string, FullLoadData> data;
+  std::vector<std::string> pluginNames;
+  for (const auto& plugin : gameHandle->GetLoadedPlugins()) {
+    data.emplace(boost::to_lower_copy(plugin->GetName()),
+                 FullLoadData(*plugin));
+    pluginNames.push_back(plugin->GetName());
+  }
+
+  // Loading the headers replaces the fully loaded plugins, so their records
+  // are freed.
+  gameHandle->LoadPlugins(pluginNames, true);
+
+  lock_guard<mutex> guard(mutex_);
+  AdoptCompactPlugins(gameHandle->GetLoadedPlugins(), data);
+}
+
+void Game::AdoptCompactPlugins(
+    const std::set<std::shared_ptr<const PluginInterface>>& headers,
+    const std::map<std::string, FullLoadData>& data) {
+  adoptedPlugins_.clear();
+  for (const auto& header : headers) {
+    auto key = boost::to_lower_copy(header->GetName());
+    auto it = data.find(key);
+    adoptedPlugins_.emplace(
+        key,
+        std::make_shared<CompactPlugin>(
+            header, it == data.end() ? FullLoadData() : it->second,
+            formIdIndex_));
+  }
+  pluginsFullyLoaded_ = true;
+}
+
+std::shared_ptr<GameInterface> Game::GetGameHandle() const {
+  lock_guard<mutex> guard(gameHandleMutex_);
+
+  if (!gameHandle_) {
+    if (logger_) {
+      logger_->debug("Creating game handle for {}.", Name());
+    }
+    gameHandle_ = CreateDetachedGameHandle();
+  }
+
+  return gameHandle_;
+}
+
+std::shared_ptr<GameInterface> Game::GetExistingGameHandle() const {
+  lock_guard<mutex> guard(gameHandleMutex_);
+
+  return gameHandle_;
+}
+
+std::shared_ptr<GameInterface> Game::CreateDetachedGameHandle() const {
+  auto handle =
+      CreateGameHandle(Type(), GamePath().string(), localDataPath_.string());
+  handle->IdentifyMainMasterFile(Master());
+
+  return handle;
+}
+
+size_t Game::GetInstallFingerprint() const {
+  PhaseTimer timer("fingerprintInstall");
+  size_t fingerprint = 0;
+  auto hashFile = [&](const fs::path& path) {
+    boost::system::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec)
+      return;
+    auto time = fs::last_write_time(path, ec);
+    if (ec)
+      return;
+
+    boost::hash_combine(fingerprint,
+                        boost::to_lower_copy(path.filename().string()));
+    boost::hash_combine(fingerprint, size);
+    boost::hash_combine(fingerprint, time);
+  };
+
+  // Metadata conditions can also check other files, e.g. archives, script
+  // extender DLLs and the game's executables. Subfolders are hashed by
+  // modification time, which only changes when their direct contents do, as
+  // walking the whole Data folder would take too long.
+  auto hashDirectory = [&](const fs::path& path) {
+    boost::system::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    if (ec)
+      return;
+
+    boost::hash_combine(fingerprint,
+                        boost::to_lower_copy(path.filename().string()));
+    boost::hash_combine(fingerprint, time);
+  };
+
+  // Sort the entries so that the fingerprint doesn't depend on the
+  // filesystem's iteration order.
+  std::set<fs::path> plugins;
+  std::set<fs::path> otherFiles;
+  std::set<fs::path> directories;
+  boost::system::error_code ec;
+  for (fs::directory_iterator it(DataPath(), ec);
+       !ec && it != fs::directory_iterator();
+       it.increment(ec)) {
+    auto filename = it->path().filename().string();
+    if (boost::iends_with(filename, ".ghost"))
+      filename = it->path().stem().string();
+
+    if (fs::is_directory(it->status()))
+      directories.insert(it->path());
+    else if (!fs::is_regular_file(it->status()))
+      continue;
+    else if (hasPluginFileExtension(filename))
+      plugins.insert(it->path());
+    else
+      otherFiles.insert(it->path());
+  }
+
+  for (fs::directory_iterator it(GamePath(), ec);
+       !ec && it != fs::directory_iterator();
+       it.increment(ec)) {
+    if (fs::is_regular_file(it->status()))
+      otherFiles.insert(it->path());
+  }
+
+  for (const auto& plugin : plugins) {
+    hashFile(plugin);
+  }
+  for (const auto& file : otherFiles) {
+    hashFile(file);
+  }
+  for (const auto& directory : directories) {
+    hashDirectory(directory);
+  }
+
+  auto localPath = GameLocalPath();
+  if (!localPath.empty()) {
+    hashFile(localPath / "plugins.txt");
+    hashFile(localPath / "loadorder.txt");
+  }
+
+  return fingerprint;
+}
+
+bool Game::IsLoadedStateCurrent() const {
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (loadedInstallFingerprint_ == 0)
+      return false;
+  }
+
+  return GetInstallFingerprint() == loadedInstallFingerprint_;
+}
+
+size_t Game::GetLoadedInstallFingerprint() const {
+  lock_guard<mutex> guard(mutex_);
+
+  return loadedInstallFingerprint_;
+}
+
+void Game::Unload() {
+  if (logger_) {
+    logger_->info("Unloading plugins and metadata for {}.", Name());
+  }
+
+  {
+    // A new handle will be created when it is next needed.
+    lock_guard<mutex> guard(gameHandleMutex_);
+    gameHandle_.reset();
+  }
+
+  {
+    lock_guard<mutex> guard(mutex_);
+    pluginsFullyLoaded_ = false;
+    adoptedPlugins_.clear();
+    ++pluginsLoadId_;
+    loadedInstallFingerprint_ = 0;
+    violationsKey_.clear();
+    violations_.clear();
+    derivedDataKey_.clear();
+    derivedData_.clear();
+    derivedData_.shrink_to_fit();
+    messages_.clear();
+  }
+  formIdIndex_->Clear();
+
+  BumpMetadataGeneration();
+  PublishSnapshot();
+}
+
+size_t Game::EstimateMemoryUsage() const {
+  return GetMemoryUsage().Total();
+}
+
+GameMemoryUsage Game::GetMemoryUsage() const {
+  // Fully loaded plugins are compacted, so every plugin holds little more
+  // than its header record.
+  static constexpr size_t pluginSize = 4 * 1024;
+  // Parsed metadata takes up several times the space of its YAML source.
+  static constexpr size_t metadataSizeFactor = 4;
+
+  GameMemoryUsage usage;
+
+  // Plugins and metadata are only loaded once the game has a handle.
+  if (GetExistingGameHandle()) {
+    usage.plugins = GetPlugins().size() * pluginSize;
+
+    for (const auto& path : {MasterlistPath(), UserlistPath()}) {
+      boost::system::error_code ec;
+      auto size = fs::file_size(path, ec);
+      if (!ec)
+        usage.metadata += metadataSizeFactor * static_cast<size_t>(size);
+    }
+  }
+
+  usage.formIdIndex = formIdIndex_->EstimateMemoryUsage();
+  usage.state = GetSnapshot()->EstimateMemoryUsage();
+
+  lock_guard<mutex> guard(mutex_);
+  usage.derivedData = derivedDataKey_.capacity() + derivedData_.capacity();
+
+  for (const auto& message : messages_) {
+    usage.state += sizeof(Message);
+    for (const auto& content : message.GetContent()) {
+      usage.state += sizeof(MessageContent) + content.GetText().size();
+    }
+  }
+  for (const auto& plugin : sortResult_) {
+    usage.state += sizeof(std::string) + plugin.capacity();
+  }
+  for (const auto& violation : violations_) {
+    usage.state += sizeof(LoadOrderViolation) + violation.plugin.capacity() +
+                   violation.otherPlugin.capacity();
+  }
+  usage.state += sortResultFingerprints_.size() *
+                 (sizeof(size_t) + 3 * sizeof(void*));
+
+  return usage;
+}
+
+std::shared_ptr<FormIdIndex> Game::GetFormIdIndex() const {
+  return formIdIndex_;
+}
+
+void Game::UpdateFormIdIndex(const std::atomic<bool>* cancelled) {
+  PhaseTimer timer("updateFormIdIndex");
+  formIdIndex_->Update(
+      Type(), DataPath(), GetInstalledPluginNames(), cancelled);
+}
+
+std::string Game::GetCachedDerivedData(const std::string& key) const {
+  lock_guard<mutex> guard(mutex_);
+
+  if (key.empty() || key != derivedDataKey_)
+    return "";
+
+  return std::string(derivedData_.data(), derivedData_.size());
+}
+
+void Game::CacheDerivedData(const std::string& key, const std::string& data) {
+  lock_guard<mutex> guard(mutex_);
+
+  derivedDataKey_ = key;
+  derivedData_.assign(data.data(), data.size());
+}
 
 boost::filesystem::path Game::DataPath() const {
   if (GamePath().empty())
@@ -322,6 +831,8 @@ boost::filesystem::path Game::DataPath() const {
   return GamePath() / "Data";
 }
 
+fs::path Game::LocalDataPath() const { return localDataPath_; }
+
 fs::path Game::MasterlistPath() const {
   return lootDataPath_ / FolderName() / "masterlist.yaml";
 }
@@ -331,16 +842,27 @@ fs::path Game::UserlistPath() const {
 }
 
 std::vector<std::string> Game::GetLoadOrder() const {
-  return gameHandle_->GetLoadOrder();
+  return GetGameHandle()->GetLoadOrder();
 }
 
 void Game::SetLoadOrder(const std::vector<std::string>& loadOrder) {
-  BackupLoadOrder(GetLoadOrder(), lootDataPath_ / FolderName());
-  gameHandle_->SetLoadOrder(loadOrder);
+  bool wasCurrent = IsLoadedStateCurrent();
+  // Applying the stored sort result changes the install, so remember that
+  // the result also applies to the changed install.
+  bool isSortResult = !loadOrder.empty() &&
+                      GetStoredSortResult(GetSortFingerprint()) == loadOrder;
+  BackupLoadOrder(GetLoadOrder(), profileDataPath_);
+  GetGameHandle()->SetLoadOrder(loadOrder);
+  if (wasCurrent)
+    StoreInstallFingerprint(GetInstallFingerprint());
+  if (isSortResult)
+    StoreSortResult(GetSortFingerprint(), loadOrder, false);
+
+  PublishSnapshot();
 }
 
 bool Game::IsPluginActive(const std::string& pluginName) const {
-  return gameHandle_->IsPluginActive(pluginName);
+  return GetGameHandle()->IsPluginActive(pluginName);
 }
 
 short Game::GetActiveLoadOrderIndex(
@@ -369,13 +891,42 @@ short Game::GetActiveLoadOrderIndex(
 }
 
 std::vector<std::string> Game::SortPlugins() {
-  std::vector<std::string> plugins = GetInstalledPluginNames();
+  auto fingerprint = GetInstallFingerprint();
+  auto sortFingerprint = GetSortFingerprint();
+  std::vector<std::string> plugins = GetStoredSortResult(sortFingerprint);
+  if (!plugins.empty()) {
+    if (logger_) {
+      logger_->info(
+          "Nothing has changed since the load order was last sorted, reusing "
+          "the last sort result.");
+    }
+    ClearMessages();
+    IncrementLoadOrderSortCount();
+
+    return plugins;
+  }
+
+  plugins = GetInstalledPluginNames();
   try {
     // Clear any existing game-specific messages, as these only relate to
     // state that has been changed by sorting.
     ClearMessages();
 
-    plugins = gameHandle_->SortPlugins(plugins);
+    {
+      PhaseTimer timer("sortPlugins");
+      plugins = GetGameHandle()->SortPlugins(plugins);
+    }
+
+    {
+      // Sorting fully loads the plugins through the game handle.
+      lock_guard<mutex> guard(mutex_);
+      adoptedPlugins_.clear();
+      ++pluginsLoadId_;
+    }
+    CompactLoadedPlugins();
+    PublishSnapshot();
+    StoreInstallFingerprint(fingerprint);
+    StoreSortResult(sortFingerprint, plugins, true);
 
     IncrementLoadOrderSortCount();
   } catch (CyclicInteractionError& e) {
@@ -400,30 +951,171 @@ std::vector<std::string> Game::SortPlugins() {
   return plugins;
 }
 
-void Game::IncrementLoadOrderSortCount() {
+std::vector<LoadOrderViolation> Game::CheckLoadOrder() const {
+  // Conditions in the metadata are evaluated when checking, so this is too
+  // slow to repeat for every query that shows general messages.
+  const std::string key = std::to_string(GetSnapshot()->GetVersion()) + ":" +
+                          std::to_string(GetMetadataGeneration());
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (key == violationsKey_)
+      return violations_;
+  }
+
+  auto violations = FindLoadOrderViolations();
+
   lock_guard<mutex> guard(mutex_);
+  violationsKey_ = key;
+  violations_ = violations;
+
+  return violations;
+}
+
+std::vector<LoadOrderViolation> Game::FindLoadOrderViolations() const {
+  PhaseTimer timer("checkLoadOrder");
+  std::unordered_map<std::string, std::shared_ptr<const PluginInterface>>
+      plugins;
+  for (const auto& plugin : GetPlugins()) {
+    plugins.emplace(boost::to_lower_copy(plugin->GetName()), plugin);
+  }
+  if (plugins.empty())
+    return std::vector<LoadOrderViolation>();
+
+  std::vector<std::shared_ptr<const PluginInterface>> loadOrder;
+  std::unordered_map<std::string, size_t> positions;
+  for (const auto& pluginName : GetLoadOrder()) {
+    auto key = boost::to_lower_copy(pluginName);
+    auto it = plugins.find(key);
+    if (it != plugins.end() && positions.emplace(key, loadOrder.size()).second)
+      loadOrder.push_back(it->second);
+  }
+
+  std::vector<LoadOrderViolation> violations;
+  for (size_t i = 0; i < loadOrder.size(); ++i) {
+    const auto& plugin = loadOrder[i];
+    auto check = [&](const std::string& otherPlugin,
+                     LoadOrderViolation::Reason reason) {
+      auto it = positions.find(boost::to_lower_copy(otherPlugin));
+      if (it != positions.end() && it->second > i) {
+        violations.push_back(LoadOrderViolation{
+            plugin->GetName(), loadOrder[it->second]->GetName(), reason});
+      }
+    };
 
-  ++loadOrderSortCount_;
+    for (const auto& master : plugin->GetMasters()) {
+      check(master, LoadOrderViolation::Reason::master);
+    }
+
+    auto metadata = GetMasterlistMetadata(plugin->GetName(), true);
+    metadata.MergeMetadata(GetUserMetadata(plugin->GetName(), true));
+    for (const auto& file : metadata.GetLoadAfterFiles()) {
+      check(file.GetName(), LoadOrderViolation::Reason::loadAfter);
+    }
+    for (const auto& file : metadata.GetRequirements()) {
+      check(file.GetName(), LoadOrderViolation::Reason::requirement);
+    }
+  }
+
+  if (logger_) {
+    logger_->debug("Found {} load order violations.", violations.size());
+  }
+
+  return violations;
+}
+
+Message Game::ToMessage(const LoadOrderViolation& violation) {
+  std::string format;
+  switch (violation.reason) {
+    case LoadOrderViolation::Reason::master:
+      format = boost::locale::translate(
+          "\"%1%\" loads before its master \"%2%\".");
+      break;
+    case LoadOrderViolation::Reason::loadAfter:
+      format = boost::locale::translate(
+          "\"%1%\" loads before \"%2%\", but should load after it.");
+      break;
+    default:
+      format = boost::locale::translate(
+          "\"%1%\" loads before \"%2%\", which it requires.");
+      break;
+  }
+
+  return Message(
+      MessageType::warn,
+      (boost::format(format) % violation.plugin % violation.otherPlugin).str());
+}
+
+bool Game::IsLoadOrderSorted() const {
+  auto sortResult = GetStoredSortResult(GetSortFingerprint());
+  if (sortResult.empty())
+    return false;
+
+  // The load order may list plugins that aren't installed.
+  std::set<std::string> sortedPlugins(sortResult.begin(), sortResult.end());
+  std::vector<std::string> loadOrder;
+  for (const auto& plugin : GetLoadOrder()) {
+    if (sortedPlugins.count(plugin) != 0)
+      loadOrder.push_back(plugin);
+  }
+
+  return loadOrder == sortResult;
+}
+
+bool Game::IsSortResultStored() const {
+  return !GetStoredSortResult(GetSortFingerprint()).empty();
+}
+
+void Game::IncrementLoadOrderSortCount() {
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    ++loadOrderSortCount_;
+  }
+
+  PublishSnapshot();
 }
 
 void Game::DecrementLoadOrderSortCount() {
-  lock_guard<mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
 
-  if (loadOrderSortCount_ > 0)
-    --loadOrderSortCount_;
+    if (loadOrderSortCount_ > 0)
+      --loadOrderSortCount_;
+  }
+
+  PublishSnapshot();
+}
+
+std::shared_ptr<const GameSnapshot> Game::GetSnapshot() const {
+  return std::atomic_load(&snapshot_);
 }
 
 std::vector<Message> Game::GetMessages() const {
-  std::vector<Message> output(
-      gameHandle_->GetDatabase()->GetGeneralMessages(true));
-  output.insert(end(output), begin(messages_), end(messages_));
+  // A game without a handle has no metadata or plugins loaded, so only its
+  // own messages apply. Don't create a handle just to find that out, as the
+  // game may have just been unloaded.
+  auto gameHandle = GetExistingGameHandle();
+  std::vector<Message> output;
+  if (gameHandle)
+    output = gameHandle->GetDatabase()->GetGeneralMessages(true);
+
+  unsigned short loadOrderSortCount;
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    output.insert(end(output), begin(messages_), end(messages_));
+    loadOrderSortCount = loadOrderSortCount_;
+  }
 
-  if (loadOrderSortCount_ == 0)
+  if (loadOrderSortCount == 0)
     output.push_back(
         Message(MessageType::warn,
                 boost::locale::translate(
                     "You have not sorted your load order this session.")));
 
+  if (!gameHandle)
+    return output;
+
   size_t activeNormalPluginsCount = 0;
   bool hasActiveEsl = false;
   for (const auto& plugin : GetPlugins()) {
@@ -453,39 +1145,76 @@ std::vector<Message> Game::GetMessages() const {
 }
 
 void Game::AppendMessage(const Message& message) {
-  lock_guard<mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
 
-  messages_.push_back(message);
+    messages_.push_back(message);
+  }
+
+  PublishSnapshot();
 }
 
 void Game::ClearMessages() {
-  lock_guard<mutex> guard(mutex_);
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    messages_.clear();
+  }
 
-  messages_.clear();
+  PublishSnapshot();
 }
 
 bool Game::UpdateMasterlist() {
-  bool wasUpdated = gameHandle_->GetDatabase()->UpdateMasterlist(
+  auto update = UpdateMasterlist(GetGameHandle()->GetDatabase());
+  RecordMasterlistUpdate(update);
+
+  return update.isUpdated;
+}
+
+MasterlistUpdate Game::UpdateMasterlistFile() {
+  auto handle = CreateDetachedGameHandle();
+
+  return UpdateMasterlist(handle->GetDatabase());
+}
+
+void Game::RecordMasterlistUpdate(const MasterlistUpdate& update) {
+  if (!update.isUpdated)
+    return;
+
+  BumpMetadataGeneration();
+  if (update.isLatestValid) {
+    PublishSnapshot();
+    return;
+  }
+
+  AppendMessage(Message(
+      MessageType::error,
+      boost::locale::translate("The latest masterlist revision contains a "
+                               "syntax error, LOOT is using the most recent "
+                               "valid revision instead. Syntax errors are "
+                               "usually minor and fixed within hours.")));
+}
+
+MasterlistUpdate Game::UpdateMasterlist(
+    std::shared_ptr<DatabaseInterface> database) const {
+  MasterlistUpdate update;
+  update.isUpdated = database->UpdateMasterlist(
       MasterlistPath().string(), RepoURL(), RepoBranch());
-  if (wasUpdated && !gameHandle_->GetDatabase()->IsLatestMasterlist(
-                        MasterlistPath().string(), RepoBranch())) {
-    AppendMessage(Message(
-        MessageType::error,
-        boost::locale::translate("The latest masterlist revision contains a "
-                                 "syntax error, LOOT is using the most recent "
-                                 "valid revision instead. Syntax errors are "
-                                 "usually minor and fixed within hours.")));
+  if (update.isUpdated) {
+    update.isLatestValid = database->IsLatestMasterlist(
+        MasterlistPath().string(), RepoBranch());
   }
 
-  return wasUpdated;
+  return update;
 }
 
 MasterlistInfo Game::GetMasterlistInfo() const {
-  return gameHandle_->GetDatabase()->GetMasterlistRevision(
+  return GetGameHandle()->GetDatabase()->GetMasterlistRevision(
       MasterlistPath().string(), true);
 }
 
 void Game::LoadMetadata() {
+  PhaseTimer timer("loadMetadata");
   std::string masterlistPath;
   std::string userlistPath;
   if (boost::filesystem::exists(MasterlistPath())) {
@@ -505,8 +1234,9 @@ void Game::LoadMetadata() {
   if (logger_) {
     logger_->debug("Parsing metadata list(s).");
   }
+  BumpMetadataGeneration();
   try {
-    gameHandle_->GetDatabase()->LoadLists(masterlistPath, userlistPath);
+    GetGameHandle()->GetDatabase()->LoadLists(masterlistPath, userlistPath);
   } catch (std::exception& e) {
     if (logger_) {
       logger_->error("An error occurred while parsing the metadata list(s): {}",
@@ -530,52 +1260,262 @@ void Game::LoadMetadata() {
          e.what())
             .str()));
   }
+
+  PublishSnapshot();
 }
 
 std::set<std::string> Game::GetKnownBashTags() const {
-  return gameHandle_->GetDatabase()->GetKnownBashTags();
+  return GetGameHandle()->GetDatabase()->GetKnownBashTags();
 }
 
 PluginMetadata Game::GetMasterlistMetadata(const std::string& pluginName,
                                            bool evaluateConditions) const {
-  return gameHandle_->GetDatabase()->GetPluginMetadata(
+  return GetGameHandle()->GetDatabase()->GetPluginMetadata(
       pluginName, false, evaluateConditions);
 }
 
 PluginMetadata Game::GetUserMetadata(const std::string& pluginName,
                                      bool evaluateConditions) const {
-  return gameHandle_->GetDatabase()->GetPluginUserMetadata(pluginName,
+  return GetGameHandle()->GetDatabase()->GetPluginUserMetadata(pluginName,
                                                            evaluateConditions);
 }
 
 void Game::AddUserMetadata(const PluginMetadata& metadata) {
-  gameHandle_->GetDatabase()->SetPluginUserMetadata(metadata);
+  GetGameHandle()->GetDatabase()->SetPluginUserMetadata(metadata);
+  BumpMetadataGeneration();
 }
 
 void Game::ClearUserMetadata(const std::string& pluginName) {
-  gameHandle_->GetDatabase()->DiscardPluginUserMetadata(pluginName);
+  GetGameHandle()->GetDatabase()->DiscardPluginUserMetadata(pluginName);
+  BumpMetadataGeneration();
 }
 
 void Game::ClearAllUserMetadata() {
-  gameHandle_->GetDatabase()->DiscardAllUserMetadata();
+  GetGameHandle()->GetDatabase()->DiscardAllUserMetadata();
+  BumpMetadataGeneration();
 }
 
 void Game::SaveUserMetadata() {
-  gameHandle_->GetDatabase()->WriteUserMetadata(UserlistPath().string(), true);
+  GetGameHandle()->GetDatabase()->WriteUserMetadata(UserlistPath().string(), true);
+}
+
+unsigned int Game::GetMetadataGeneration() const {
+  return metadataGeneration_->load();
+}
+
+void Game::PublishSnapshot() {
+  lock_guard<mutex> guard(snapshotMutex_);
+
+  if (!GetExistingGameHandle()) {
+    std::shared_ptr<const GameSnapshot> snapshot =
+        std::make_shared<GameSnapshot>(
+            ++snapshotVersion_,
+            std::vector<std::string>(),
+            std::vector<std::shared_ptr<const PluginInterface>>(),
+            std::set<std::string>(),
+            GetMessages());
+    std::atomic_store(&snapshot_, snapshot);
+    return;
+  }
+
+  auto plugins = GetPlugins();
+  std::set<std::string> activePlugins;
+  for (const auto& plugin : plugins) {
+    if (IsPluginActive(plugin->GetName())) {
+      activePlugins.insert(boost::to_lower_copy(plugin->GetName()));
+    }
+  }
+
+  std::shared_ptr<const GameSnapshot> snapshot =
+      std::make_shared<GameSnapshot>(
+          ++snapshotVersion_,
+          GetLoadOrder(),
+          std::vector<std::shared_ptr<const PluginInterface>>(plugins.begin(),
+                                                              plugins.end()),
+          activePlugins,
+          GetMessages());
+
+  std::atomic_store(&snapshot_, snapshot);
+}
+
+void Game::StoreInstallFingerprint(size_t fingerprint) {
+  lock_guard<mutex> guard(mutex_);
+  loadedInstallFingerprint_ = fingerprint;
+}
+
+size_t Game::GetSortFingerprint() const {
+  size_t fingerprint = GetInstallFingerprint();
+
+  // The metadata files are always saved when changed, so their content
+  // stands in for the loaded metadata. A missing file hashes the same as an
+  // empty file, which is equivalent.
+  for (const auto& path : {MasterlistPath(), UserlistPath()}) {
+    std::string content;
+    fs::ifstream in(path, std::ios::binary);
+    if (in.good()) {
+      content.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+    }
+    boost::hash_combine(fingerprint, content);
+  }
+
+  return fingerprint;
+}
+
+std::vector<std::string> Game::GetStoredSortResult(size_t fingerprint) const {
+  lock_guard<mutex> guard(mutex_);
+  LoadStoredSortResult();
+
+  if (sortResultFingerprints_.count(fingerprint) == 0)
+    return std::vector<std::string>();
+
+  return sortResult_;
+}
+
+void Game::StoreSortResult(size_t fingerprint,
+                           const std::vector<std::string>& sortResult,
+                           bool isNewResult) {
+  lock_guard<mutex> guard(mutex_);
+  LoadStoredSortResult();
+
+  if (isNewResult) {
+    sortResult_ = sortResult;
+    sortResultFingerprints_.clear();
+  } else if (sortResult != sortResult_ ||
+             sortResultFingerprints_.count(fingerprint) != 0) {
+    return;
+  }
+
+  sortResultFingerprints_.insert(fingerprint);
+  SaveStoredSortResult();
+}
+
+// The file has a header line, a line of space-separated fingerprints, and
+// then one sorted plugin name per line.
+void Game::LoadStoredSortResult() const {
+  if (sortResultLoaded_)
+    return;
+
+  sortResultLoaded_ = true;
+  if (sortResultPath_.empty())
+    return;
+
+  fs::ifstream in(sortResultPath_);
+  std::string line;
+  if (!std::getline(in, line) || line != "LOOT sort result 1")
+    return;
+
+  std::set<size_t> fingerprints;
+  if (std::getline(in, line)) {
+    std::istringstream fingerprintsStream(line);
+    size_t fingerprint;
+    while (fingerprintsStream >> fingerprint) {
+      fingerprints.insert(fingerprint);
+    }
+  }
+
+  std::vector<std::string> sortResult;
+  while (std::getline(in, line)) {
+    if (!line.empty())
+      sortResult.push_back(line);
+  }
+
+  if (!sortResult.empty()) {
+    sortResultFingerprints_ = fingerprints;
+    sortResult_ = sortResult;
+  }
+}
+
+void Game::SaveStoredSortResult() const {
+  if (sortResultPath_.empty())
+    return;
+
+  try {
+    auto tempPath = sortResultPath_;
+    tempPath += ".tmp";
+    {
+      fs::ofstream out(tempPath, std::ios::trunc);
+      out << "LOOT sort result 1\n";
+      for (const auto fingerprint : sortResultFingerprints_) {
+        out << fingerprint << ' ';
+      }
+      out << '\n';
+      for (const auto& plugin : sortResult_) {
+        out << plugin << '\n';
+      }
+
+      if (!out.good())
+        throw std::runtime_error("write failed");
+    }
+    fs::rename(tempPath, sortResultPath_);
+  } catch (std::exception& e) {
+    if (logger_) {
+      logger_->error("Could not store the sort result at {}: {}",
+                     sortResultPath_.string(),
+                     e.what());
+    }
+  }
+}
+
+fs::path Game::GameLocalPath() const {
+  if (!localDataPath_.empty())
+    return localDataPath_;
+
+#ifdef _WIN32
+  switch (Type()) {
+    case GameType::tes4:
+      return LootPaths::getLocalAppDataPath() / "Oblivion";
+    case GameType::tes5:
+      return LootPaths::getLocalAppDataPath() / "Skyrim";
+    case GameType::tes5se:
+      return LootPaths::getLocalAppDataPath() / "Skyrim Special Edition";
+    case GameType::fo3:
+      return LootPaths::getLocalAppDataPath() / "Fallout3";
+    case GameType::fonv:
+      return LootPaths::getLocalAppDataPath() / "FalloutNV";
+    case GameType::fo4:
+      return LootPaths::getLocalAppDataPath() / "Fallout4";
+    default:
+      return "";
+  }
+#else
+  return "";
+#endif
+}
+
+void Game::BumpMetadataGeneration() {
+  metadataGeneration_->store(++nextMetadataGeneration_);
 }
 
 bool Game::ExecutableExists(const GameType& gameType,
-                            const boost::filesystem::path& gamePath) {
+                            const boost::filesystem::path& gamePath,
+                            MissingPathCache& missingPaths) {
   if (gameType == GameType::tes5) {
-    return fs::exists(gamePath / "TESV.exe");
+    return missingPaths.Exists(gamePath / "TESV.exe");
   } else if (gameType == GameType::tes5se) {
-    return fs::exists(gamePath / "SkyrimSE.exe");
+    return missingPaths.Exists(gamePath / "SkyrimSE.exe");
   } else {
     return true;  // Don't bother checking for the other games.
   }
 }
 
+bool Game::IsGameAtPath(const GameSettings& gameSettings,
+                        const boost::filesystem::path& gamePath,
+                        MissingPathCache& missingPaths) {
+  // Checking the Data folder first means that a missing install is usually
+  // found to be missing without probing for every game's master file.
+  return missingPaths.Exists(gamePath / "Data") &&
+         missingPaths.Exists(gamePath / "Data" / gameSettings.Master());
+}
+
 boost::filesystem::path Game::DetectGamePath(const GameSettings& gameSettings) {
+  MissingPathCache missingPaths;
+
+  return DetectGamePath(gameSettings, missingPaths);
+}
+
+boost::filesystem::path Game::DetectGamePath(const GameSettings& gameSettings,
+                                             MissingPathCache& missingPaths) {
   auto logger = getLogger();
   try {
     if (logger) {
@@ -583,12 +1523,12 @@ boost::filesystem::path Game::DetectGamePath(const GameSettings& gameSettings) {
         gameSettings.Name());
     }
     if (!gameSettings.GamePath().empty() &&
-        fs::exists(gameSettings.GamePath() / "Data" / gameSettings.Master()))
+        IsGameAtPath(gameSettings, gameSettings.GamePath(), missingPaths))
       return gameSettings.GamePath();
 
     boost::filesystem::path gamePath = "..";
-    if (fs::exists(gamePath / "Data" / gameSettings.Master()) &&
-        ExecutableExists(gameSettings.Type(), gamePath)) {
+    if (IsGameAtPath(gameSettings, gamePath, missingPaths) &&
+        ExecutableExists(gameSettings.Type(), gamePath, missingPaths)) {
       return gamePath;
     }
 
@@ -599,8 +1539,8 @@ boost::filesystem::path Game::DetectGamePath(const GameSettings& gameSettings) {
         fs::path(gameSettings.RegistryKey()).filename().string();
     gamePath = RegKeyStringValue("HKEY_LOCAL_MACHINE", key_parent, key_name);
     if (!gamePath.empty() &&
-        fs::exists(gamePath / "Data" / gameSettings.Master()) &&
-        ExecutableExists(gameSettings.Type(), gamePath)) {
+        IsGameAtPath(gameSettings, gamePath, missingPaths) &&
+        ExecutableExists(gameSettings.Type(), gamePath, missingPaths)) {
       return gamePath;
     }
 #endif
@@ -714,6 +1654,7 @@ Message Game::ToMessage(const PluginCleaningData& cleaningData) {
 }
 
 std::vector<std::string> Game::GetInstalledPluginNames() {
+  PhaseTimer timer("scanDataFolder");
   std::vector<std::string> plugins;
 
   if (logger_) {
@@ -725,7 +1666,7 @@ std::vector<std::string> Game::GetInstalledPluginNames() {
        it != fs::directory_iterator();
        ++it) {
     if (fs::is_regular_file(it->status()) &&
-        gameHandle_->IsValidPlugin(it->path().filename().string())) {
+        GetGameHandle()->IsValidPlugin(it->path().filename().string())) {
       string name = it->path().filename().string();
 
       if (logger_) {
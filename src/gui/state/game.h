@@ -25,22 +25,57 @@
 #ifndef LOOT_GUI_STATE_GAME
 #define LOOT_GUI_STATE_GAME
 
+#include <atomic>
+#include <map>
 #include <mutex>
+#include <set>
 #include <string>
 
 #include <boost/filesystem.hpp>
 #include <spdlog/spdlog.h>
 
+#include "gui/state/compact_plugin.h"
+#include "gui/state/form_id_index.h"
 #include "gui/state/game_settings.h"
+#include "gui/state/game_snapshot.h"
+#include "gui/state/memory_usage.h"
 #include "loot/api.h"
 
 namespace loot {
 namespace gui {
+class MissingPathCache;
+
+// A plugin that loads before a plugin that it must load after.
+struct LoadOrderViolation {
+  enum struct Reason {
+    master,
+    loadAfter,
+    requirement,
+  };
+
+  std::string plugin;
+  std::string otherPlugin;
+  Reason reason;
+};
+
+// The outcome of updating a game's masterlist file.
+struct MasterlistUpdate {
+  MasterlistUpdate() : isUpdated(false), isLatestValid(true) {}
+
+  bool isUpdated;
+  // False if the latest revision has a syntax error, so the most recent valid
+  // revision was used instead.
+  bool isLatestValid;
+};
+
 class Game : public GameSettings {
 public:
+  // If detectGamePath is false, the given settings' game path is used as it
+  // is, e.g. because it has already been found by DetectGamePaths().
   Game(const GameSettings& gameSettings,
        const boost::filesystem::path& lootDataPath,
-       const boost::filesystem::path& localDataPath = "");
+       const boost::filesystem::path& localDataPath = "",
+       bool detectGamePath = true);
   Game(const Game& game);
 
   Game& operator=(const Game& game);
@@ -48,7 +83,17 @@ public:
   using GameSettings::Type;
 
   static bool IsInstalled(const GameSettings& gameSettings);
+  // Detects the install paths of the given games in parallel, returning them
+  // in the same order. Games that aren't installed get an empty path.
+  static std::vector<boost::filesystem::path> DetectGamePaths(
+      const std::vector<GameSettings>& gameSettings);
   static Message ToMessage(const PluginCleaningData& cleaningData);
+
+  // Creates a game for another profile of this game's install, i.e. one that
+  // has its own load order files in the given local data path. The profile
+  // shares this game's masterlist, userlist and FormID index, but has its own
+  // game handle, load order backups and stored sort result.
+  Game CreateProfile(const boost::filesystem::path& localDataPath) const;
   void Init();
 
   std::shared_ptr<const PluginInterface> GetPlugin(
@@ -60,12 +105,79 @@ public:
 
   void RedatePlugins();  // Change timestamps to match load order (Skyrim only).
 
-  void LoadAllInstalledPlugins(
-      bool headersOnly);  // Loads all installed plugins.
+  // Loads all installed plugins. Fully loaded plugins are compacted once
+  // loaded, so only their headers are kept, along with the data from the
+  // full load that LOOT uses. Their FormIDs are held by the FormID index.
+  void LoadAllInstalledPlugins(bool headersOnly);
   bool ArePluginsFullyLoaded()
       const;  // Checks if the game's plugins have already been loaded.
 
+  // Changes every time the installed plugins are (re)loaded.
+  unsigned int GetPluginsLoadId() const;
+
+  // Use the data from fully loading the installed plugins through a detached
+  // game handle, keyed by lowercased plugin name, with the currently loaded
+  // plugin headers, so that the plugins count as fully loaded without their
+  // records being kept. The data is discarded and false is returned if the
+  // installed plugins have been reloaded since the given load ID was
+  // obtained.
+  bool AdoptFullLoadData(const std::map<std::string, FullLoadData>& data,
+                         unsigned int pluginsLoadId);
+
+  // Use the plugins that the given game has loaded in place of loading them
+  // again, e.g. for another profile of the same install. The games must have
+  // the same data path.
+  void ShareLoadedPlugins(const Game& game);
+  // Use the given plugins in place of loading the installed plugins. They
+  // must have been loaded from files identical to the installed plugins.
+  void ShareLoadedPlugins(
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins,
+      bool pluginsFullyLoaded);
+
+  // Creates a new handle for this game that shares no loaded plugins or
+  // metadata with the game's own handle.
+  std::shared_ptr<GameInterface> CreateDetachedGameHandle() const;
+  std::vector<std::string> GetInstalledPluginNames();
+
+  // A hash of the names, sizes and modification times of the installed
+  // plugins, the load order files and the other files directly in the Data
+  // and game folders, and of the modification times of the Data folder's
+  // subfolders.
+  size_t GetInstallFingerprint() const;
+
+  // Checks if plugins have been loaded and the install hasn't changed since.
+  bool IsLoadedStateCurrent() const;
+  // The install fingerprint when plugins were last loaded, or 0 if they
+  // haven't been.
+  size_t GetLoadedInstallFingerprint() const;
+
+  // Frees the loaded plugins, metadata and cached derived data. Everything
+  // will be loaded again the next time the game's data is loaded. User
+  // metadata must have been saved first.
+  void Unload();
+
+  // The index is shared by copies of this game, and is safe to use from any
+  // thread.
+  std::shared_ptr<FormIdIndex> GetFormIdIndex() const;
+  // Brings the FormID index up to date with the installed plugins.
+  void UpdateFormIdIndex(const std::atomic<bool>* cancelled = nullptr);
+
+  // A rough estimate, in bytes, of the memory used by the loaded plugins,
+  // metadata and cached derived data.
+  size_t EstimateMemoryUsage() const;
+  // The same estimate, broken down by what uses the memory. A game that has
+  // nothing loaded uses none.
+  GameMemoryUsage GetMemoryUsage() const;
+
+  // Holds one piece of serialised data derived from the game's state,
+  // identified by a key that should change whenever the state it was derived
+  // from does. An empty string is returned if the key doesn't match.
+  std::string GetCachedDerivedData(const std::string& key) const;
+  void CacheDerivedData(const std::string& key, const std::string& data);
+
   boost::filesystem::path DataPath() const;
+  // Empty if the game's default local data path is used.
+  boost::filesystem::path LocalDataPath() const;
   boost::filesystem::path MasterlistPath() const;
   boost::filesystem::path UserlistPath() const;
 
@@ -77,15 +189,44 @@ public:
       const std::shared_ptr<const PluginInterface>& plugin,
       const std::vector<std::string>& loadOrder) const;
 
+  // Sorting with the same installed plugins, load order and metadata as a
+  // previous sort returns that sort's result without sorting again. The last
+  // result is stored in the game's LOOT data folder so that it's kept between
+  // sessions.
   std::vector<std::string> SortPlugins();
+  // Checks the current load order of the loaded plugins against their
+  // masters and their evaluated load after and requirement metadata. This
+  // takes time linear in the number of plugins and constraints, but unlike
+  // sorting doesn't take plugin priorities or overlap into account. The
+  // result is reused until the snapshot or metadata generation changes.
+  std::vector<LoadOrderViolation> CheckLoadOrder() const;
+  static Message ToMessage(const LoadOrderViolation& violation);
+  // Checks if the last sort result applies to the current installed plugins,
+  // load order and metadata, and matches the current load order.
+  bool IsLoadOrderSorted() const;
+  // Checks if sorting now would reuse the last sort result.
+  bool IsSortResultStored() const;
   void IncrementLoadOrderSortCount();
   void DecrementLoadOrderSortCount();
 
+  // Returns the most recently published snapshot of the game's state. This
+  // doesn't block, and is safe to call from any thread.
+  std::shared_ptr<const GameSnapshot> GetSnapshot() const;
+
   std::vector<Message> GetMessages() const;
   void AppendMessage(const Message& message);
   void ClearMessages();
 
   bool UpdateMasterlist();
+  // Updates the masterlist file through its own game handle, without touching
+  // anything else of the game's, so it is safe to call while plugins are being
+  // loaded. The outcome must be passed to RecordMasterlistUpdate() once
+  // nothing else is using the game, and LoadMetadata() must be called to use
+  // the updated masterlist.
+  MasterlistUpdate UpdateMasterlistFile();
+  // Invalidates data derived from the old masterlist, and adds a message if
+  // the latest masterlist revision was invalid.
+  void RecordMasterlistUpdate(const MasterlistUpdate& update);
   MasterlistInfo GetMasterlistInfo() const;
 
   void LoadMetadata();
@@ -100,6 +241,11 @@ public:
   void ClearAllUserMetadata();
   void SaveUserMetadata();
 
+  // Returns a value that changes whenever the loaded masterlist or user
+  // metadata changes. Values are unique across all games, so they can be used
+  // to check if data derived from metadata is still current.
+  unsigned int GetMetadataGeneration() const;
+
 private:
 #ifdef _WIN32
   static std::string RegKeyStringValue(const std::string& keyStr,
@@ -107,24 +253,95 @@ private:
                                        const std::string& value);
 #endif
   static bool ExecutableExists(const GameType& gameType,
-                               const boost::filesystem::path& gamePath);
+                               const boost::filesystem::path& gamePath,
+                               MissingPathCache& missingPaths);
+  static bool IsGameAtPath(const GameSettings& gameSettings,
+                           const boost::filesystem::path& gamePath,
+                           MissingPathCache& missingPaths);
   static boost::filesystem::path DetectGamePath(
       const GameSettings& gameSettings);
+  static boost::filesystem::path DetectGamePath(
+      const GameSettings& gameSettings,
+      MissingPathCache& missingPaths);
   static void BackupLoadOrder(const std::vector<std::string>& loadOrder,
                               const boost::filesystem::path& backupDirectory);
-  std::vector<std::string> GetInstalledPluginNames();
+  MasterlistUpdate UpdateMasterlist(
+      std::shared_ptr<DatabaseInterface> database) const;
+  void BumpMetadataGeneration();
+  std::vector<LoadOrderViolation> FindLoadOrderViolations() const;
+  void PublishSnapshot();
+  std::shared_ptr<GameInterface> GetGameHandle() const;
+  std::shared_ptr<GameInterface> GetExistingGameHandle() const;
+  void StoreInstallFingerprint(size_t fingerprint);
+  // Replaces the game handle's fully loaded plugins with their headers,
+  // keeping only what LOOT uses from the full load.
+  void CompactLoadedPlugins();
+  // Must be called with mutex_ held.
+  void AdoptCompactPlugins(
+      const std::set<std::shared_ptr<const PluginInterface>>& headers,
+      const std::map<std::string, FullLoadData>& data);
+  // A hash of the install fingerprint and the metadata list files' content.
+  size_t GetSortFingerprint() const;
+  // Returns an empty vector if no stored sort result has the fingerprint.
+  std::vector<std::string> GetStoredSortResult(size_t fingerprint) const;
+  void StoreSortResult(size_t fingerprint,
+                       const std::vector<std::string>& sortResult,
+                       bool isNewResult);
+  void LoadStoredSortResult() const;
+  void SaveStoredSortResult() const;
+  boost::filesystem::path GameLocalPath() const;
+
+  static std::atomic<unsigned int> nextMetadataGeneration_;
 
   boost::filesystem::path lootDataPath_;
+  boost::filesystem::path localDataPath_;
 
-  std::shared_ptr<GameInterface> gameHandle_;
+  // Created when first needed, as most games are never selected. Only
+  // accessed through GetGameHandle() and GetExistingGameHandle().
+  mutable std::shared_ptr<GameInterface> gameHandle_;
+  std::shared_ptr<std::atomic<unsigned int>> metadataGeneration_;
+  std::shared_ptr<FormIdIndex> formIdIndex_;
   bool pluginsFullyLoaded_;
+  unsigned int pluginsLoadId_;
+  std::map<std::string, std::shared_ptr<const PluginInterface>>
+      adoptedPlugins_;
+  size_t loadedInstallFingerprint_;
+
+  // Where load order backups and the stored sort result are kept.
+  boost::filesystem::path profileDataPath_;
+
+  // The last sort result and the sort fingerprints it applies to, including
+  // any that the install had after the result was applied. Loaded from
+  // sortResultPath_ when first needed, and guarded by mutex_.
+  boost::filesystem::path sortResultPath_;
+  mutable bool sortResultLoaded_;
+  mutable std::set<size_t> sortResultFingerprints_;
+  mutable std::vector<std::string> sortResult_;
+
+  // The last CheckLoadOrder() result, and the snapshot version and metadata
+  // generation it was found for.
+  mutable std::string violationsKey_;
+  mutable std::vector<LoadOrderViolation> violations_;
+
+  std::string derivedDataKey_;
+  std::basic_string<char,
+                    std::char_traits<char>,
+                    CountingAllocator<char, MemorySubsystem::derivedData>>
+      derivedData_;
 
   std::vector<Message> messages_;
   unsigned short loadOrderSortCount_;
 
   std::shared_ptr<spdlog::logger> logger_;
 
+  // Only accessed through std::atomic_load() and std::atomic_store().
+  std::shared_ptr<const GameSnapshot> snapshot_;
+  unsigned int snapshotVersion_;
+
   mutable std::mutex mutex_;
+  mutable std::mutex gameHandleMutex_;
+  // Serialises publishing so that snapshots are published in version order.
+  std::mutex snapshotMutex_;
 };
 }
 }
@@ -0,0 +1,230 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game_batch.h"
+
+#include <algorithm>
+#include <future>
+
+#include <boost/format.hpp>
+#include <boost/locale.hpp>
+
+#include "gui/state/logging.h"
+#include "gui/state/performance_stats.h"
+
+namespace loot {
+namespace gui {
+namespace {
+std::vector<SimpleMessage> toSimpleMessages(
+    const std::vector<Message>& messages,
+    const std::string& language) {
+  std::vector<SimpleMessage> simpleMessages;
+  for (const auto& message : messages) {
+    simpleMessages.push_back(message.ToSimpleMessage(language));
+  }
+
+  return simpleMessages;
+}
+
+bool hasProblems(const std::vector<SimpleMessage>& messages) {
+  return std::any_of(
+      begin(messages), end(messages), [](const SimpleMessage& message) {
+        return message.type != MessageType::say;
+      });
+}
+
+std::vector<Message> getPluginMessages(
+    Game& game,
+    const std::shared_ptr<const PluginInterface>& plugin) {
+  try {
+    auto metadata = game.GetMasterlistMetadata(plugin->GetName(), true);
+    auto messages = metadata.GetMessages();
+    auto validityMessages = game.CheckInstallValidity(plugin, metadata);
+    messages.insert(
+        end(messages), begin(validityMessages), end(validityMessages));
+
+    auto userMessages =
+        game.GetUserMetadata(plugin->GetName(), true).GetMessages();
+    messages.insert(end(messages), begin(userMessages), end(userMessages));
+
+    return messages;
+  } catch (std::exception& e) {
+    return {
+        Message(MessageType::error,
+                (boost::format(boost::locale::translate(
+                     "\"%1%\" contains a condition that could not be "
+                     "evaluated. Details: %2%")) %
+                 plugin->GetName() % e.what())
+                    .str()),
+    };
+  }
+}
+
+// If a plugin source is given, its loaded plugins are used instead of
+// loading the game's plugins again.
+GameBatchResult processGame(Game& game,
+                            const GameBatchOptions& options,
+                            const Game* pluginSource = nullptr) {
+  auto start = std::chrono::steady_clock::now();
+
+  GameBatchResult result;
+  result.folderName = game.FolderName();
+
+  try {
+    game.Init();
+
+    // Load the metadata once, after the masterlist has been updated.
+    if (options.updateMasterlist) {
+      auto update = game.UpdateMasterlistFile();
+      game.RecordMasterlistUpdate(update);
+      result.isMasterlistUpdated = update.isUpdated;
+    }
+    if (pluginSource)
+      game.ShareLoadedPlugins(*pluginSource);
+    else
+      game.LoadAllInstalledPlugins(true);
+    game.LoadMetadata();
+
+    auto loadOrder = game.GetLoadOrder();
+    result.sortedLoadOrder = game.SortPlugins();
+    result.isSorted = !result.sortedLoadOrder.empty();
+    result.isLoadOrderChanged =
+        result.isSorted && result.sortedLoadOrder != loadOrder;
+
+    // An unchanged load order is still set, as some plugins' positions may
+    // only be inferred and not written to the load order files.
+    if (result.isSorted && options.applySortedLoadOrder) {
+      game.SetLoadOrder(result.sortedLoadOrder);
+      result.isApplied = true;
+    }
+
+    auto messages = game.GetMessages();
+    for (const auto& violation : game.CheckLoadOrder()) {
+      messages.push_back(Game::ToMessage(violation));
+    }
+    result.generalMessages = toSimpleMessages(messages, options.language);
+    result.isValid = !hasProblems(result.generalMessages);
+
+    for (const auto& pluginName : game.GetLoadOrder()) {
+      auto plugin = game.GetPlugin(pluginName);
+      if (!plugin)
+        continue;
+
+      auto pluginMessages = toSimpleMessages(getPluginMessages(game, plugin),
+                                             options.language);
+      if (pluginMessages.empty())
+        continue;
+
+      result.isValid = result.isValid && !hasProblems(pluginMessages);
+      result.pluginMessages.emplace_back(plugin->GetName(), pluginMessages);
+    }
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Batch processing of {} failed. Details: {}",
+                    game.Name(),
+                    e.what());
+    }
+    result.error = e.what();
+    result.isValid = false;
+  }
+
+  result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  return result;
+}
+}
+
+GameBatchOptions::GameBatchOptions() :
+    updateMasterlist(false),
+    applySortedLoadOrder(false),
+    language(MessageContent::defaultLanguage) {}
+
+GameBatchResult::GameBatchResult() :
+    isMasterlistUpdated(false),
+    isSorted(false),
+    isLoadOrderChanged(false),
+    isApplied(false),
+    isValid(false),
+    duration(0) {}
+
+std::vector<GameBatchResult> runGameBatch(const std::vector<Game*>& games,
+                                          const GameBatchOptions& options) {
+  std::vector<std::future<GameBatchResult>> futures;
+  for (auto game : games) {
+    futures.push_back(std::async(std::launch::async, [game, &options]() {
+      return processGame(*game, options);
+    }));
+  }
+
+  std::vector<GameBatchResult> results;
+  for (auto& future : futures) {
+    results.push_back(future.get());
+  }
+
+  return results;
+}
+
+std::vector<GameBatchResult> runProfileBatch(
+    Game& game,
+    const std::vector<Game*>& profiles,
+    const GameBatchOptions& options) {
+  // The profiles share the game's masterlist and installed plugins, so
+  // update and load them once, reusing any plugins that are already loaded.
+  bool isMasterlistUpdated = false;
+  {
+    PhaseTimer timer("prepareProfiles");
+    game.Init();
+    if (options.updateMasterlist) {
+      auto update = game.UpdateMasterlistFile();
+      game.RecordMasterlistUpdate(update);
+      isMasterlistUpdated = update.isUpdated;
+    }
+    if (!game.IsLoadedStateCurrent())
+      game.LoadAllInstalledPlugins(true);
+  }
+
+  GameBatchOptions profileOptions = options;
+  profileOptions.updateMasterlist = false;
+
+  std::vector<std::future<GameBatchResult>> futures;
+  for (auto profile : profiles) {
+    futures.push_back(
+        std::async(std::launch::async, [&game, profile, &profileOptions]() {
+          return processGame(*profile, profileOptions, &game);
+        }));
+  }
+
+  std::vector<GameBatchResult> results;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    results.push_back(futures[i].get());
+    results.back().profilePath = profiles[i]->LocalDataPath().string();
+    results.back().isMasterlistUpdated = isMasterlistUpdated;
+  }
+
+  return results;
+}
+}
+}
@@ -0,0 +1,91 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_BATCH
+#define LOOT_GUI_STATE_GAME_BATCH
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gui/state/game.h"
+#include "loot/api.h"
+
+namespace loot {
+namespace gui {
+struct GameBatchOptions {
+  GameBatchOptions();
+
+  bool updateMasterlist;
+  bool applySortedLoadOrder;
+  // The language that messages are given in.
+  std::string language;
+};
+
+struct GameBatchResult {
+  GameBatchResult();
+
+  std::string folderName;
+  // The local data path of the profile that was processed, if any.
+  std::string profilePath;
+  // Empty unless processing the game failed, in which case the rest of the
+  // result may be incomplete.
+  std::string error;
+  bool isMasterlistUpdated;
+  // False if sorting failed, e.g. because of a cyclic interaction.
+  bool isSorted;
+  bool isLoadOrderChanged;
+  bool isApplied;
+  std::vector<std::string> sortedLoadOrder;
+  // The game's general messages, including any problems with its load order
+  // as it is once the batch has finished.
+  std::vector<SimpleMessage> generalMessages;
+  // The plugins that have messages, in load order.
+  std::vector<std::pair<std::string, std::vector<SimpleMessage>>>
+      pluginMessages;
+  // True if none of the messages are warnings or errors.
+  bool isValid;
+  std::chrono::milliseconds duration;
+};
+
+// Updates the masterlists of, loads, sorts and checks the given games, each
+// on its own thread and through its own game handle, so that the batch takes
+// about as long as the slowest game. The games must not be used by anything
+// else until this returns. Results are given in the same order as the games.
+std::vector<GameBatchResult> runGameBatch(const std::vector<Game*>& games,
+                                          const GameBatchOptions& options);
+
+// As runGameBatch(), but for profiles of the given game, which are expected
+// to have been created using Game::CreateProfile(). The game's masterlist is
+// updated and its installed plugins are loaded once, and the profiles share
+// them. Only the profiles' load orders and stored sort results are changed.
+std::vector<GameBatchResult> runProfileBatch(
+    Game& game,
+    const std::vector<Game*>& profiles,
+    const GameBatchOptions& options);
+}
+}
+
+#endif
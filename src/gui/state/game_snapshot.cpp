@@ -0,0 +1,135 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game_snapshot.h"
+
+#include <boost/algorithm/string.hpp>
+
+namespace loot {
+namespace gui {
+GameSnapshot::GameSnapshot() : version_(0) {}
+
+GameSnapshot::GameSnapshot(
+    unsigned int version,
+    const std::vector<std::string>& loadOrder,
+    const std::vector<std::shared_ptr<const PluginInterface>>& plugins,
+    const std::set<std::string>& activePlugins,
+    const std::vector<Message>& messages) :
+    version_(version),
+    loadOrder_(loadOrder),
+    messages_(messages) {
+  for (const auto& plugin : plugins) {
+    PluginFacts facts;
+    facts.name = plugin->GetName();
+    facts.version = plugin->GetVersion();
+    facts.crc = plugin->GetCRC();
+    facts.isActive = activePlugins.count(boost::to_lower_copy(facts.name)) > 0;
+    facts.isMaster = plugin->IsMaster();
+    facts.isLightMaster = plugin->IsLightMaster();
+    facts.isEmpty = plugin->IsEmpty();
+    facts.loadsArchive = plugin->LoadsArchive();
+    facts.activeLoadOrderIndex = -1;
+
+    plugins_.emplace(boost::to_lower_copy(facts.name), facts);
+  }
+
+  // Light masters and other plugins are indexed separately, so count both
+  // in a single pass over the load order.
+  short activeNormalCount = 0;
+  short activeLightMasterCount = 0;
+  for (const auto& pluginName : loadOrder_) {
+    auto it = plugins_.find(boost::to_lower_copy(pluginName));
+    if (it == plugins_.end() || !it->second.isActive) {
+      continue;
+    }
+
+    if (it->second.isLightMaster) {
+      it->second.activeLoadOrderIndex = activeLightMasterCount++;
+    } else {
+      it->second.activeLoadOrderIndex = activeNormalCount++;
+    }
+  }
+}
+
+unsigned int GameSnapshot::GetVersion() const { return version_; }
+
+const std::vector<std::string>& GameSnapshot::GetLoadOrder() const {
+  return loadOrder_;
+}
+
+const std::vector<Message>& GameSnapshot::GetMessages() const {
+  return messages_;
+}
+
+const GameSnapshot::PluginFacts* GameSnapshot::GetPluginFacts(
+    const std::string& pluginName) const {
+  auto it = plugins_.find(boost::to_lower_copy(pluginName));
+  if (it == plugins_.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+bool GameSnapshot::IsPluginActive(const std::string& pluginName) const {
+  auto facts = GetPluginFacts(pluginName);
+
+  return facts != nullptr && facts->isActive;
+}
+
+short GameSnapshot::GetActiveLoadOrderIndex(
+    const std::string& pluginName) const {
+  auto facts = GetPluginFacts(pluginName);
+  if (facts == nullptr) {
+    return -1;
+  }
+
+  return facts->activeLoadOrderIndex;
+}
+
+size_t GameSnapshot::EstimateMemoryUsage() const {
+  size_t estimate = sizeof(GameSnapshot);
+
+  for (const auto& pluginName : loadOrder_) {
+    estimate += sizeof(std::string) + pluginName.capacity();
+  }
+
+  for (const auto& message : messages_) {
+    estimate += sizeof(Message);
+    for (const auto& content : message.GetContent()) {
+      estimate += sizeof(MessageContent) + content.GetText().size();
+    }
+  }
+
+  // Each map node holds its key and value, plus three pointers and a colour.
+  for (const auto& plugin : plugins_) {
+    estimate += sizeof(plugin) + 4 * sizeof(void*) + plugin.first.capacity() +
+                plugin.second.name.capacity() +
+                plugin.second.version.capacity();
+  }
+
+  return estimate;
+}
+}
+}
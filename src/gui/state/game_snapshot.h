@@ -0,0 +1,90 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_SNAPSHOT
+#define LOOT_GUI_STATE_GAME_SNAPSHOT
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "loot/api.h"
+
+namespace loot {
+namespace gui {
+// An immutable copy of the parts of a game's state that queries read the
+// most. Games publish a new snapshot whenever that state changes, so a
+// snapshot can be read from any thread without locking, and always gives a
+// consistent view.
+class GameSnapshot {
+public:
+  struct PluginFacts {
+    std::string name;
+    std::string version;
+    uint32_t crc;
+    bool isActive;
+    bool isMaster;
+    bool isLightMaster;
+    bool isEmpty;
+    bool loadsArchive;
+    // -1 if the plugin is inactive or not in the load order.
+    short activeLoadOrderIndex;
+  };
+
+  GameSnapshot();
+  GameSnapshot(
+      unsigned int version,
+      const std::vector<std::string>& loadOrder,
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins,
+      const std::set<std::string>& activePlugins,
+      const std::vector<Message>& messages);
+
+  // Increases with every snapshot that a game publishes.
+  unsigned int GetVersion() const;
+
+  const std::vector<std::string>& GetLoadOrder() const;
+  const std::vector<Message>& GetMessages() const;
+
+  // Returns nullptr if the plugin is not loaded.
+  const PluginFacts* GetPluginFacts(const std::string& pluginName) const;
+  bool IsPluginActive(const std::string& pluginName) const;
+  short GetActiveLoadOrderIndex(const std::string& pluginName) const;
+
+  // A rough estimate, in bytes, of the memory that the snapshot holds.
+  size_t EstimateMemoryUsage() const;
+
+private:
+  unsigned int version_;
+  std::vector<std::string> loadOrder_;
+  std::vector<Message> messages_;
+  // Keyed by lowercased plugin name.
+  std::map<std::string, PluginFacts> plugins_;
+};
+}
+}
+
+#endif
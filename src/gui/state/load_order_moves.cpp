@@ -0,0 +1,130 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/load_order_moves.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace loot {
+namespace gui {
+std::vector<LoadOrderMove> getLoadOrderMoves(
+    const std::vector<std::string>& fromLoadOrder,
+    const std::vector<std::string>& toLoadOrder) {
+  if (fromLoadOrder.size() != toLoadOrder.size())
+    throw std::invalid_argument("Load orders contain different plugins");
+
+  std::unordered_map<std::string, size_t> fromIndices;
+  for (size_t i = 0; i < fromLoadOrder.size(); ++i) {
+    fromIndices.emplace(fromLoadOrder[i], i);
+  }
+
+  std::vector<size_t> sourceIndices;
+  sourceIndices.reserve(toLoadOrder.size());
+  std::vector<bool> isUsed(fromLoadOrder.size(), false);
+  for (const auto& name : toLoadOrder) {
+    auto it = fromIndices.find(name);
+    if (it == fromIndices.end() || isUsed[it->second])
+      throw std::invalid_argument("Load orders contain different plugins");
+
+    isUsed[it->second] = true;
+    sourceIndices.push_back(it->second);
+  }
+
+  // The plugins that don't need to move are those in the longest run of
+  // plugins that are still in the same relative order, which is the longest
+  // increasing subsequence of source indices.
+  std::vector<size_t> tails;
+  std::vector<size_t> previous(sourceIndices.size());
+  for (size_t i = 0; i < sourceIndices.size(); ++i) {
+    auto it = std::lower_bound(
+        tails.begin(), tails.end(), i, [&](size_t tail, size_t index) {
+          return sourceIndices[tail] < sourceIndices[index];
+        });
+
+    previous[i] = it == tails.begin() ? i : *(it - 1);
+    if (it == tails.end())
+      tails.push_back(i);
+    else
+      *it = i;
+  }
+
+  std::vector<bool> isStationary(sourceIndices.size(), false);
+  if (!tails.empty()) {
+    size_t i = tails.back();
+    while (true) {
+      isStationary[i] = true;
+      if (previous[i] == i)
+        break;
+      i = previous[i];
+    }
+  }
+
+  std::vector<LoadOrderMove> moves;
+  for (size_t i = 0; i < toLoadOrder.size(); ++i) {
+    if (!isStationary[i])
+      moves.push_back(LoadOrderMove{toLoadOrder[i], sourceIndices[i], i});
+  }
+
+  return moves;
+}
+
+std::vector<std::string> applyLoadOrderMoves(
+    const std::vector<std::string>& loadOrder,
+    const std::vector<LoadOrderMove>& moves) {
+  std::vector<std::string> newLoadOrder(loadOrder.size());
+  std::vector<bool> isFilled(loadOrder.size(), false);
+  std::vector<bool> isMoved(loadOrder.size(), false);
+
+  for (const auto& move : moves) {
+    if (move.from >= loadOrder.size() || move.to >= loadOrder.size() ||
+        loadOrder[move.from] != move.name || isMoved[move.from] ||
+        isFilled[move.to])
+      throw std::invalid_argument("Invalid move of \"" + move.name +
+                                  "\" for the load order");
+
+    newLoadOrder[move.to] = move.name;
+    isFilled[move.to] = true;
+    isMoved[move.from] = true;
+  }
+
+  // Plugins that weren't moved fill the remaining gaps in their existing
+  // relative order.
+  size_t to = 0;
+  for (size_t from = 0; from < loadOrder.size(); ++from) {
+    if (isMoved[from])
+      continue;
+
+    while (isFilled[to]) {
+      ++to;
+    }
+    newLoadOrder[to] = loadOrder[from];
+    isFilled[to] = true;
+  }
+
+  return newLoadOrder;
+}
+}
+}
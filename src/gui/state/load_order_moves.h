@@ -0,0 +1,56 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_LOAD_ORDER_MOVES
+#define LOOT_GUI_STATE_LOAD_ORDER_MOVES
+
+#include <string>
+#include <vector>
+
+namespace loot {
+namespace gui {
+// Moving a plugin from one index to another. Indices are into the load order
+// before and after all the moves have been made respectively.
+struct LoadOrderMove {
+  std::string name;
+  size_t from;
+  size_t to;
+};
+
+// Gets the fewest moves that turn the first load order into the second. The
+// load orders must contain the same plugins, or std::invalid_argument is
+// thrown. Plugin names are compared case-sensitively.
+std::vector<LoadOrderMove> getLoadOrderMoves(
+    const std::vector<std::string>& fromLoadOrder,
+    const std::vector<std::string>& toLoadOrder);
+
+// Makes the given moves to the given load order. Throws
+// std::invalid_argument if the moves don't fit the load order.
+std::vector<std::string> applyLoadOrderMoves(
+    const std::vector<std::string>& loadOrder,
+    const std::vector<LoadOrderMove>& moves);
+}
+}
+
+#endif
@@ -37,14 +37,14 @@ public:
   static boost::filesystem::path getSettingsPath();
   static boost::filesystem::path getLogPath();
 
+  // Get the local application data path.
+  static boost::filesystem::path getLocalAppDataPath();
+
   // Sets the app path to the current path, and the data path to the given
   // path or (if it is an empty string), local app data path / "LOOT".
   static void initialise(const std::string& lootDataPath);
 
 private:
-  // Get the local application data path.
-  static boost::filesystem::path getLocalAppDataPath();
-
   static boost::filesystem::path lootAppPath_;
   static boost::filesystem::path lootDataPath_;
 };
@@ -139,6 +139,8 @@ LootSettings::LootSettings() :
     }),
     enableDebugLogging_(false),
     updateMasterlist_(true),
+    backgroundLoadThreads_(0),
+    warmGamesMemoryLimit_(1024),
     game_("auto"),
     language_("en"),
     lastGame_("auto") {}
@@ -152,6 +154,12 @@ void LootSettings::load(const boost::filesystem::path& file) {
                             .value_or(enableDebugLogging_);
   updateMasterlist_ =
       settings->get_as<bool>("updateMasterlist").value_or(updateMasterlist_);
+  backgroundLoadThreads_ =
+      settings->get_as<unsigned int>("backgroundLoadThreads")
+          .value_or(backgroundLoadThreads_);
+  warmGamesMemoryLimit_ =
+      settings->get_as<unsigned int>("warmGamesMemoryLimit")
+          .value_or(warmGamesMemoryLimit_);
   game_ = settings->get_as<std::string>("game").value_or(game_);
   language_ = settings->get_as<std::string>("language").value_or(language_);
   lastGame_ = settings->get_as<std::string>("lastGame").value_or(lastGame_);
@@ -206,6 +214,8 @@ void LootSettings::save(const boost::filesystem::path& file) {
 
   root->insert("enableDebugLogging", enableDebugLogging_);
   root->insert("updateMasterlist", updateMasterlist_);
+  root->insert("backgroundLoadThreads", backgroundLoadThreads_);
+  root->insert("warmGamesMemoryLimit", warmGamesMemoryLimit_);
   root->insert("game", game_);
   root->insert("language", language_);
   root->insert("lastGame", lastGame_);
@@ -264,6 +274,18 @@ bool LootSettings::updateMasterlist() const {
   return updateMasterlist_;
 }
 
+unsigned int LootSettings::getBackgroundLoadThreads() const {
+  lock_guard<recursive_mutex> guard(mutex_);
+
+  return backgroundLoadThreads_;
+}
+
+unsigned int LootSettings::getWarmGamesMemoryLimit() const {
+  lock_guard<recursive_mutex> guard(mutex_);
+
+  return warmGamesMemoryLimit_;
+}
+
 bool LootSettings::isWindowPositionStored() const {
   lock_guard<recursive_mutex> guard(mutex_);
 
@@ -337,6 +359,18 @@ void LootSettings::updateMasterlist(bool update) {
   updateMasterlist_ = update;
 }
 
+void LootSettings::setBackgroundLoadThreads(unsigned int threads) {
+  lock_guard<recursive_mutex> guard(mutex_);
+
+  backgroundLoadThreads_ = threads;
+}
+
+void LootSettings::setWarmGamesMemoryLimit(unsigned int limit) {
+  lock_guard<recursive_mutex> guard(mutex_);
+
+  warmGamesMemoryLimit_ = limit;
+}
+
 void LootSettings::storeLastGame(const std::string& lastGame) {
   lock_guard<recursive_mutex> guard(mutex_);
 
@@ -54,6 +54,8 @@ public:
 
   bool isDebugLoggingEnabled() const;
   bool updateMasterlist() const;
+  unsigned int getBackgroundLoadThreads() const;
+  unsigned int getWarmGamesMemoryLimit() const;
   bool isWindowPositionStored() const;
   std::string getGame() const;
   std::string getLastGame() const;
@@ -67,6 +69,8 @@ public:
   void setLanguage(const std::string& language);
   void enableDebugLogging(bool enable);
   void updateMasterlist(bool update);
+  void setBackgroundLoadThreads(unsigned int threads);
+  void setWarmGamesMemoryLimit(unsigned int limit);
 
   void storeLastGame(const std::string& lastGame);
   void storeWindowPosition(const WindowPosition& position);
@@ -77,6 +81,8 @@ public:
 private:
   bool enableDebugLogging_;
   bool updateMasterlist_;
+  unsigned int backgroundLoadThreads_;
+  unsigned int warmGamesMemoryLimit_;
   std::string game_;
   std::string lastGame_;
   std::string lastVersion_;
@@ -24,6 +24,9 @@
 
 #include "gui/state/loot_state.h"
 
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
 #include <unordered_set>
 
 #include <boost/algorithm/string.hpp>
@@ -182,17 +185,9 @@ void LootState::init(const std::string& cmdLineGame,
     logger_->debug("Detecting installed games.");
   }
   installedGames_.clear();
-  for (const auto& gameSettings : getGameSettings()) {
-    if (gui::Game::IsInstalled(gameSettings)) {
-      if (logger_) {
-        logger_->trace("Adding new installed game entry for: {}",
-          gameSettings.FolderName());
-      }
-      installedGames_.push_back(gui::Game(
-          gameSettings, LootPaths::getLootDataPath(), gameAppDataPath));
-      updateStoredGamePathSetting(installedGames_.back());
-    }
-  }
+  // Copy the settings, as adding games updates their stored paths.
+  auto gameSettings = getGameSettings();
+  addInstalledGames(gameSettings);
 
   try {
     selectGame(cmdLineGame);
@@ -227,10 +222,23 @@ void LootState::save(const boost::filesystem::path& file) {
 void LootState::changeGame(const std::string& newGameFolder) {
   lock_guard<mutex> guard(mutex_);
 
+  backgroundPluginLoader_.Cancel();
+
   if (logger_) {
     logger_->debug("Changing current game to that with folder: {}",
       newGameFolder);
   }
+  // The new game stops being warm before the old game is stored, so that
+  // storing the old game can't unload the new game.
+  warmGames_.remove_if([&](const std::string& folder) {
+    return boost::iequals(folder, newGameFolder);
+  });
+  if (currentGame_ != installedGames_.end() &&
+      !boost::iequals(currentGame_->FolderName(), newGameFolder)) {
+    storeWarmGame(*currentGame_);
+    profiles_.clear();
+  }
+
   currentGame_ =
       find_if(installedGames_.begin(),
               installedGames_.end(),
@@ -241,6 +249,38 @@ void LootState::changeGame(const std::string& newGameFolder) {
   if (logger_) {
     logger_->debug("New game is: {}", currentGame_->Name());
   }
+
+  if (logger_ && logger_->should_log(spdlog::level::debug)) {
+    logMemoryReport(createMemoryReport(), spdlog::level::debug);
+  }
+}
+
+void LootState::loadPluginsInBackground(std::shared_ptr<EventSink> events) {
+  lock_guard<mutex> guard(mutex_);
+
+  backgroundPluginLoader_.Start(
+      *currentGame_, getBackgroundLoadThreads(), events);
+}
+
+void LootState::cancelBackgroundPluginLoad() {
+  lock_guard<mutex> guard(mutex_);
+
+  backgroundPluginLoader_.Cancel();
+}
+
+std::shared_ptr<std::atomic<bool>> LootState::startConflictMatrix() {
+  lock_guard<mutex> guard(mutex_);
+
+  conflictMatrixCancelled_ = std::make_shared<std::atomic<bool>>(false);
+  return conflictMatrixCancelled_;
+}
+
+void LootState::cancelConflictMatrix() {
+  lock_guard<mutex> guard(mutex_);
+
+  if (conflictMatrixCancelled_) {
+    *conflictMatrixCancelled_ = true;
+  }
 }
 
 gui::Game& LootState::getCurrentGame() {
@@ -257,6 +297,112 @@ std::vector<std::string> LootState::getInstalledGames() const {
   return installedGames;
 }
 
+std::vector<gui::GameBatchResult> LootState::runGameBatch(
+    const std::vector<std::string>& gameFolders,
+    gui::GameBatchOptions options) {
+  std::vector<gui::Game*> games;
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    // The batch uses the current game too.
+    backgroundPluginLoader_.Cancel();
+
+    for (auto& game : installedGames_) {
+      bool isSelected =
+          gameFolders.empty() ||
+          std::any_of(begin(gameFolders),
+                      end(gameFolders),
+                      [&](const std::string& folder) {
+                        return boost::iequals(folder, game.FolderName());
+                      });
+      if (isSelected)
+        games.push_back(&game);
+    }
+  }
+
+  for (const auto& folder : gameFolders) {
+    bool isInstalled = std::any_of(
+        begin(games), end(games), [&](const gui::Game* game) {
+          return boost::iequals(folder, game->FolderName());
+        });
+    if (!isInstalled) {
+      throw std::invalid_argument(
+          (format(translate("The game \"%1%\" is not installed.")) % folder)
+              .str());
+    }
+  }
+
+  if (logger_) {
+    logger_->info("Running a batch for {} games.", games.size());
+  }
+
+  options.language = getLanguage();
+  auto results = gui::runGameBatch(games, options);
+
+  // The batch loads every game it processes, so unload those that weren't
+  // already kept loaded, and keep the warm games within their limits.
+  lock_guard<mutex> guard(mutex_);
+  for (auto game : games) {
+    bool isWarm = std::any_of(begin(warmGames_),
+                              end(warmGames_),
+                              [&](const std::string& folder) {
+                                return boost::iequals(folder,
+                                                      game->FolderName());
+                              });
+    if (game != &*currentGame_ && !isWarm)
+      game->Unload();
+  }
+  unloadExcessWarmGames();
+
+  return results;
+}
+
+std::vector<gui::GameBatchResult> LootState::runProfileBatch(
+    const std::vector<std::string>& profilePaths,
+    gui::GameBatchOptions options) {
+  gui::Game* game = nullptr;
+  std::vector<gui::Game*> profiles;
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    // The batch uses the current game's loaded plugins.
+    backgroundPluginLoader_.Cancel();
+    game = &*currentGame_;
+
+    for (const auto& profilePath : profilePaths) {
+      if (!boost::filesystem::is_directory(profilePath)) {
+        throw std::invalid_argument(
+            (format(translate("The profile folder \"%1%\" does not exist.")) %
+             profilePath)
+                .str());
+      }
+
+      auto it = find_if(begin(profiles_),
+                        end(profiles_),
+                        [&](const gui::Game& profile) {
+                          return profile.LocalDataPath() == profilePath;
+                        });
+      if (it == end(profiles_)) {
+        profiles_.push_back(game->CreateProfile(profilePath));
+        it = std::prev(end(profiles_));
+      }
+
+      // Each profile must only be processed once, as they run concurrently.
+      if (std::find(begin(profiles), end(profiles), &*it) == end(profiles))
+        profiles.push_back(&*it);
+    }
+  }
+
+  if (logger_) {
+    logger_->info("Running a batch for {} profiles of {}.",
+                  profiles.size(),
+                  game->Name());
+  }
+
+  options.language = getLanguage();
+  return gui::runProfileBatch(*game, profiles, options);
+}
+
 bool LootState::hasUnappliedChanges() const {
   return unappliedChangeCounter_ > 0;
 }
@@ -314,6 +460,7 @@ void LootState::storeGameSettings(
 
   // Update existing games, add new games.
   std::unordered_set<string> newGameFolders;
+  vector<GameSettings> newGames;
   if (logger_) {
     logger_->trace("Updating existing games and adding new games.");
   }
@@ -329,19 +476,12 @@ void LootState::storeGameSettings(
           .SetGamePath(gameSettings.GamePath())
           .SetRegistryKey(gameSettings.RegistryKey());
     } else {
-      if (gui::Game::IsInstalled(gameSettings)) {
-        if (logger_) {
-          logger_->trace("Adding new installed game entry for: {}",
-            gameSettings.FolderName());
-        }
-        installedGames_.push_back(gui::Game(
-            gameSettings, LootPaths::getLootDataPath(), gameAppDataPath));
-        updateStoredGamePathSetting(installedGames_.back());
-      }
+      newGames.push_back(gameSettings);
     }
 
     newGameFolders.insert(gameSettings.FolderName());
   }
+  addInstalledGames(newGames);
 
   // Remove deleted games. As the current game is stored using its index,
   // removing an earlier game may invalidate it.
@@ -372,6 +512,159 @@ std::shared_ptr<spdlog::logger> LootState::getLogger() const {
   return logger_;
 }
 
+gui::PerformanceStats& LootState::getPerformanceStats() {
+  return performanceStats_;
+}
+
+gui::MemoryReport LootState::getMemoryReport() {
+  lock_guard<mutex> guard(mutex_);
+
+  auto report = createMemoryReport();
+  logMemoryReport(report, spdlog::level::info);
+
+  return report;
+}
+
+void LootState::addInstalledGames(
+    const std::vector<GameSettings>& gameSettings) {
+  auto gamePaths = gui::Game::DetectGamePaths(gameSettings);
+
+  for (size_t i = 0; i < gameSettings.size(); ++i) {
+    if (gamePaths[i].empty())
+      continue;
+
+    if (logger_) {
+      logger_->trace("Adding new installed game entry for: {}",
+        gameSettings[i].FolderName());
+    }
+    // Pass in the detected path so that the game doesn't detect it again.
+    installedGames_.push_back(
+        gui::Game(GameSettings(gameSettings[i]).SetGamePath(gamePaths[i]),
+                  LootPaths::getLootDataPath(),
+                  gameAppDataPath,
+                  false));
+    updateStoredGamePathSetting(installedGames_.back());
+  }
+}
+
+void LootState::storeWarmGame(const gui::Game& game) {
+  warmGames_.remove_if([&](const std::string& folder) {
+    return boost::iequals(folder, game.FolderName());
+  });
+  warmGames_.push_front(game.FolderName());
+
+  unloadExcessWarmGames();
+}
+
+void LootState::unloadExcessWarmGames() {
+  const size_t memoryLimit =
+      static_cast<size_t>(getWarmGamesMemoryLimit()) * 1024 * 1024;
+  size_t memoryUsage = 0;
+  for (auto it = warmGames_.begin(); it != warmGames_.end();) {
+    auto gameIt = find_if(installedGames_.begin(),
+                          installedGames_.end(),
+                          [&](const gui::Game& installedGame) {
+                            return boost::iequals(*it,
+                                                  installedGame.FolderName());
+                          });
+    if (gameIt == installedGames_.end()) {
+      it = warmGames_.erase(it);
+      continue;
+    }
+
+    const size_t gameMemoryUsage = gameIt->EstimateMemoryUsage();
+    memoryUsage += gameMemoryUsage;
+    size_t position = std::distance(warmGames_.begin(), it);
+    if (position < maxWarmGames_ && memoryUsage <= memoryLimit) {
+      ++it;
+      continue;
+    }
+
+    if (logger_) {
+      logger_->debug("Unloading warm game {} to stay within limits. Estimated "
+                     "memory used by warm games: {} bytes",
+                     gameIt->Name(),
+                     memoryUsage);
+    }
+    memoryUsage -= gameMemoryUsage;
+    gameIt->Unload();
+    it = warmGames_.erase(it);
+  }
+}
+
+gui::MemoryReport LootState::createMemoryReport() const {
+  gui::MemoryReport report;
+
+  auto addGame = [&](const gui::Game& game, bool isProfile) {
+    auto usage = game.GetMemoryUsage();
+    if (usage.plugins == 0 && usage.metadata == 0 && usage.formIdIndex == 0 &&
+        usage.derivedData == 0)
+      return;
+
+    gui::MemoryReport::Game entry;
+    entry.name = game.Name();
+    entry.folderName = game.FolderName();
+    if (isProfile)
+      entry.profilePath = game.LocalDataPath().string();
+    entry.isCurrent = !isProfile && currentGame_ != installedGames_.end() &&
+                      &game == &*currentGame_;
+    entry.usage = usage;
+    report.games.push_back(entry);
+  };
+
+  for (const auto& game : installedGames_) {
+    addGame(game, false);
+  }
+  for (const auto& profile : profiles_) {
+    addGame(profile, true);
+  }
+
+  for (const auto subsystem : gui::MemoryCounters::GetSubsystems()) {
+    report.subsystems.push_back({gui::MemoryCounters::GetName(subsystem),
+                                 gui::MemoryCounters::Get(subsystem)});
+  }
+
+  report.heap = gui::GetHeapStats();
+
+  return report;
+}
+
+void LootState::logMemoryReport(const gui::MemoryReport& report,
+                                spdlog::level::level_enum level) const {
+  if (!logger_)
+    return;
+
+  for (const auto& game : report.games) {
+    logger_->log(level,
+                 "Memory used by {}{}: {} bytes in total, {} for plugins, {} "
+                 "for metadata, {} for the FormID index, {} for derived data "
+                 "and {} for other state",
+                 game.name,
+                 game.profilePath.empty() ? "" : " (" + game.profilePath + ")",
+                 game.usage.Total(),
+                 game.usage.plugins,
+                 game.usage.metadata,
+                 game.usage.formIdIndex,
+                 game.usage.derivedData,
+                 game.usage.state);
+  }
+
+  for (const auto& subsystem : report.subsystems) {
+    logger_->log(level,
+                 "Memory counted for {}: {} bytes in {} allocations",
+                 subsystem.name,
+                 subsystem.count.bytes,
+                 subsystem.count.allocations);
+  }
+
+  if (report.heap.isAvailable) {
+    logger_->log(level,
+                 "Heap usage: {} bytes allocated, {} bytes reserved",
+                 report.heap.allocated,
+                 report.heap.reserved);
+  }
+}
+
 void LootState::updateStoredGamePathSetting(const gui::Game& game) {
 
   auto gameSettings = getGameSettings();
@@ -25,10 +25,17 @@
 #ifndef LOOT_GUI_STATE_LOOT_STATE
 #define LOOT_GUI_STATE_LOOT_STATE
 
+#include <atomic>
+
 #include <spdlog/spdlog.h>
 
+#include "gui/state/background_plugin_loader.h"
+#include "gui/state/event_sink.h"
 #include "gui/state/game.h"
+#include "gui/state/game_batch.h"
 #include "gui/state/loot_settings.h"
+#include "gui/state/memory_usage.h"
+#include "gui/state/performance_stats.h"
 
 namespace loot {
 class LootState : public LootSettings {
@@ -43,9 +50,35 @@ public:
   gui::Game& getCurrentGame();
   void changeGame(const std::string& newGameFolder);
 
+  // Fully load the current game's plugins on a low-priority thread.
+  void loadPluginsInBackground(std::shared_ptr<EventSink> events);
+  void cancelBackgroundPluginLoad();
+
+  // Returns a flag that is set if cancelConflictMatrix() is called before the
+  // next call to this function. Cancelling is done from the UI thread, while
+  // the conflict matrix is computed on the file thread.
+  std::shared_ptr<std::atomic<bool>> startConflictMatrix();
+  void cancelConflictMatrix();
+
   // Get the folder names of the installed games.
   std::vector<std::string> getInstalledGames() const;
 
+  // Runs a batch on the installed games with the given folder names, or on
+  // all installed games if no names are given. Messages are given in LOOT's
+  // language. Games other than the current game and warm games are unloaded
+  // afterwards. Throws std::invalid_argument if a game isn't installed.
+  std::vector<gui::GameBatchResult> runGameBatch(
+      const std::vector<std::string>& gameFolders,
+      gui::GameBatchOptions options);
+
+  // Runs a batch on the current game for each of the given profiles, which
+  // are identified by the paths of the folders holding their load order
+  // files. Profiles are kept loaded between batches until the current game
+  // changes. Throws std::invalid_argument if a profile folder doesn't exist.
+  std::vector<gui::GameBatchResult> runProfileBatch(
+      const std::vector<std::string>& profilePaths,
+      gui::GameBatchOptions options);
+
   bool hasUnappliedChanges() const;
   void incrementUnappliedChangeCounter();
   void decrementUnappliedChangeCounter();
@@ -55,16 +88,52 @@ public:
 
   std::shared_ptr<spdlog::logger> getLogger() const;
 
+  // Timings of recent queries, for diagnosing slow operations.
+  gui::PerformanceStats& getPerformanceStats();
+
+  // Breaks down the memory used by the installed games and profiles that
+  // have data loaded, and by the subsystems whose allocations are counted.
+  // The report is also logged.
+  gui::MemoryReport getMemoryReport();
+
 private:
   // Select initial game.
   void selectGame(std::string cmdLineGame);
   void updateStoredGamePathSetting(const gui::Game& game);
+  // Detect which of the given games are installed and add them.
+  void addInstalledGames(const std::vector<GameSettings>& gameSettings);
+  // Keep the given game loaded, unloading the least recently used warm games
+  // while there are too many or they use too much memory.
+  void storeWarmGame(const gui::Game& game);
+  // Unload the least recently used warm games while there are too many or
+  // they use too much memory. Must be called with mutex_ held.
+  void unloadExcessWarmGames();
+  // Must be called with mutex_ held.
+  gui::MemoryReport createMemoryReport() const;
+  void logMemoryReport(const gui::MemoryReport& report,
+                       spdlog::level::level_enum level) const;
+
+  // The maximum number of games other than the current game that are kept
+  // loaded, whatever their memory usage.
+  static constexpr size_t maxWarmGames_ = 3;
 
   std::shared_ptr<spdlog::logger> logger_;
   std::string gameAppDataPath;
   std::list<gui::Game> installedGames_;
   std::list<gui::Game>::iterator currentGame_;
   std::vector<std::string> initErrors_;
+  // Folder names of games that are kept loaded, most recently used first.
+  std::list<std::string> warmGames_;
+  // Profiles of the current game that batches have been run for.
+  std::list<gui::Game> profiles_;
+
+  // Declared after the games so that it is destroyed (and its thread
+  // stopped) before them.
+  gui::BackgroundPluginLoader backgroundPluginLoader_;
+
+  std::shared_ptr<std::atomic<bool>> conflictMatrixCancelled_;
+
+  gui::PerformanceStats performanceStats_;
 
   // Used to check if LOOT has unaccepted sorting or metadata changes on quit.
   size_t unappliedChangeCounter_;
@@ -0,0 +1,155 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/memory_usage.h"
+
+#include <atomic>
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#define NOMINMAX
+#include "windows.h"
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace loot {
+namespace gui {
+namespace {
+constexpr size_t subsystemCount =
+    static_cast<size_t>(MemorySubsystem::queryArenas) + 1;
+
+std::atomic<size_t> allocatedBytes[subsystemCount];
+std::atomic<size_t> allocationCounts[subsystemCount];
+}
+
+void MemoryCounters::Allocate(MemorySubsystem subsystem, size_t bytes) {
+  auto index = static_cast<size_t>(subsystem);
+  allocatedBytes[index].fetch_add(bytes, std::memory_order_relaxed);
+  allocationCounts[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryCounters::Deallocate(MemorySubsystem subsystem, size_t bytes) {
+  auto index = static_cast<size_t>(subsystem);
+  allocatedBytes[index].fetch_sub(bytes, std::memory_order_relaxed);
+  allocationCounts[index].fetch_sub(1, std::memory_order_relaxed);
+}
+
+MemoryCounters::Count MemoryCounters::Get(MemorySubsystem subsystem) {
+  auto index = static_cast<size_t>(subsystem);
+  Count count;
+  count.bytes = allocatedBytes[index].load(std::memory_order_relaxed);
+  count.allocations = allocationCounts[index].load(std::memory_order_relaxed);
+  return count;
+}
+
+std::string MemoryCounters::GetName(MemorySubsystem subsystem) {
+  switch (subsystem) {
+    case MemorySubsystem::formIdIndex:
+      return "formIdIndex";
+    case MemorySubsystem::derivedData:
+      return "derivedData";
+    case MemorySubsystem::queryResponses:
+      return "queryResponses";
+    case MemorySubsystem::queryArenas:
+      return "queryArenas";
+    default:
+      return "unknown";
+  }
+}
+
+std::vector<MemorySubsystem> MemoryCounters::GetSubsystems() {
+  return {
+      MemorySubsystem::formIdIndex,
+      MemorySubsystem::derivedData,
+      MemorySubsystem::queryResponses,
+      MemorySubsystem::queryArenas,
+  };
+}
+
+CountedMemoryScope::CountedMemoryScope(MemorySubsystem subsystem,
+                                       size_t bytes) :
+    subsystem_(subsystem),
+    bytes_(bytes) {
+  MemoryCounters::Allocate(subsystem_, bytes_);
+}
+
+CountedMemoryScope::~CountedMemoryScope() {
+  MemoryCounters::Deallocate(subsystem_, bytes_);
+}
+
+HeapStats::HeapStats() : isAvailable(false), allocated(0), reserved(0) {}
+
+HeapStats GetHeapStats() {
+  HeapStats stats;
+#ifdef _WIN32
+  // The C runtime allocates from the process heap.
+  HEAP_SUMMARY summary;
+  summary.cb = sizeof(summary);
+  if (HeapSummary(GetProcessHeap(), 0, &summary)) {
+    stats.isAvailable = true;
+    stats.allocated = summary.cbAllocated;
+    stats.reserved = summary.cbReserved;
+  }
+#elif defined(__APPLE__)
+  auto statistics = mstats();
+  stats.isAvailable = true;
+  stats.allocated = statistics.bytes_used;
+  stats.reserved = statistics.bytes_total;
+#elif defined(__GLIBC__)
+  // Blocks large enough to be mapped separately aren't part of the arena.
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+  auto info = mallinfo2();
+#else
+  // The older function's fields are ints, so wrap around past 2 GB.
+  auto info = mallinfo();
+#endif
+  stats.isAvailable = true;
+  stats.allocated = static_cast<size_t>(info.uordblks) +
+                    static_cast<size_t>(info.hblkhd);
+  stats.reserved =
+      static_cast<size_t>(info.arena) + static_cast<size_t>(info.hblkhd);
+#endif
+  return stats;
+}
+
+GameMemoryUsage::GameMemoryUsage() :
+    plugins(0),
+    metadata(0),
+    formIdIndex(0),
+    derivedData(0),
+    state(0) {}
+
+size_t GameMemoryUsage::Total() const {
+  return plugins + metadata + formIdIndex + derivedData + state;
+}
+}
+}
@@ -0,0 +1,173 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_MEMORY_USAGE
+#define LOOT_GUI_STATE_MEMORY_USAGE
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace loot {
+namespace gui {
+// Parts of LOOT whose own allocations are counted exactly, as opposed to
+// estimated.
+enum struct MemorySubsystem {
+  formIdIndex,
+  derivedData,
+  queryResponses,
+  queryArenas,
+};
+
+// Counts the bytes allocated and the number of allocations that are live for
+// each subsystem. Safe to use from any thread.
+class MemoryCounters {
+public:
+  struct Count {
+    size_t bytes;
+    size_t allocations;
+  };
+
+  static void Allocate(MemorySubsystem subsystem, size_t bytes);
+  static void Deallocate(MemorySubsystem subsystem, size_t bytes);
+
+  static Count Get(MemorySubsystem subsystem);
+  static std::string GetName(MemorySubsystem subsystem);
+  static std::vector<MemorySubsystem> GetSubsystems();
+};
+
+// Counts memory that isn't allocated through a CountingAllocator, e.g. a
+// buffer that is handed to another library, for as long as it is in scope.
+class CountedMemoryScope {
+public:
+  CountedMemoryScope(MemorySubsystem subsystem, size_t bytes);
+  ~CountedMemoryScope();
+
+  CountedMemoryScope(const CountedMemoryScope&) = delete;
+  CountedMemoryScope& operator=(const CountedMemoryScope&) = delete;
+
+private:
+  const MemorySubsystem subsystem_;
+  const size_t bytes_;
+};
+
+// A std::allocator that adds its allocations to the given subsystem's count.
+// It has no state, so containers that use it are no larger than ones that
+// don't.
+template <typename T, MemorySubsystem Subsystem>
+class CountingAllocator {
+public:
+  typedef T value_type;
+
+  // std::allocator_traits can't rebind an allocator with a non-type template
+  // parameter by itself.
+  template <typename U>
+  struct rebind {
+    typedef CountingAllocator<U, Subsystem> other;
+  };
+
+  CountingAllocator() noexcept {}
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U, Subsystem>&) noexcept {}
+
+  T* allocate(size_t count) {
+    T* pointer = std::allocator<T>().allocate(count);
+    MemoryCounters::Allocate(Subsystem, count * sizeof(T));
+    return pointer;
+  }
+
+  void deallocate(T* pointer, size_t count) noexcept {
+    MemoryCounters::Deallocate(Subsystem, count * sizeof(T));
+    std::allocator<T>().deallocate(pointer, count);
+  }
+};
+
+template <typename T, typename U, MemorySubsystem Subsystem>
+bool operator==(const CountingAllocator<T, Subsystem>&,
+                const CountingAllocator<U, Subsystem>&) noexcept {
+  return true;
+}
+
+template <typename T, typename U, MemorySubsystem Subsystem>
+bool operator!=(const CountingAllocator<T, Subsystem>&,
+                const CountingAllocator<U, Subsystem>&) noexcept {
+  return false;
+}
+
+// The C runtime's own statistics for the heap, where it provides them.
+struct HeapStats {
+  HeapStats();
+
+  bool isAvailable;
+  // Bytes in blocks that are currently allocated.
+  size_t allocated;
+  // Bytes that the heap has obtained from the operating system, including
+  // free blocks that haven't been returned to it.
+  size_t reserved;
+};
+
+HeapStats GetHeapStats();
+
+// The memory used by one game's data, in bytes. The plugins and metadata are
+// held by the LOOT API, so they are estimated from the number of plugins and
+// the sizes of the metadata files.
+struct GameMemoryUsage {
+  GameMemoryUsage();
+
+  size_t Total() const;
+
+  size_t plugins;
+  size_t metadata;
+  size_t formIdIndex;
+  size_t derivedData;
+  // Messages, the published snapshot, the stored sort result and the last
+  // load order violations found.
+  size_t state;
+};
+
+struct MemoryReport {
+  struct Game {
+    std::string name;
+    std::string folderName;
+    // Empty unless the game is a profile of an installed game.
+    std::string profilePath;
+    bool isCurrent;
+    GameMemoryUsage usage;
+  };
+
+  struct Subsystem {
+    std::string name;
+    MemoryCounters::Count count;
+  };
+
+  // Only games that have data loaded.
+  std::vector<Game> games;
+  std::vector<Subsystem> subsystems;
+  HeapStats heap;
+};
+}
+}
+
+#endif
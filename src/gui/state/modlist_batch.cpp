@@ -0,0 +1,445 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/modlist_batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/locale.hpp>
+
+#include "gui/state/logging.h"
+#include "gui/state/performance_stats.h"
+
+namespace fs = boost::filesystem;
+
+namespace loot {
+namespace gui {
+namespace {
+// Identifies a distinct plugin by the game it's for, its lowercased filename
+// and its CRC.
+typedef std::tuple<GameType, std::string, uint32_t> PluginKey;
+typedef std::map<PluginKey, std::shared_ptr<const PluginInterface>>
+    ParsedPlugins;
+
+struct PluginFiles {
+  std::map<fs::path, uint32_t> crcs;
+  // Errors for the files that couldn't be read.
+  std::map<fs::path, std::string> errors;
+};
+
+// Calls the function with each index in [0, count), using up to the given
+// number of threads. The function must not throw.
+template <typename Function>
+void parallelFor(size_t count, unsigned int threads, Function function) {
+  std::atomic<size_t> next(0);
+  std::vector<std::future<void>> workers;
+  for (size_t i = 0; i < std::min<size_t>(threads, count); ++i) {
+    workers.push_back(std::async(std::launch::async, [&]() {
+      for (size_t index = next++; index < count; index = next++) {
+        function(index);
+      }
+    }));
+  }
+
+  for (auto& worker : workers) {
+    worker.get();
+  }
+}
+
+uint32_t calculateCrc(const fs::path& path) {
+  fs::ifstream in(path, std::ios::binary);
+  if (!in)
+    throw std::runtime_error("Could not read " + path.string());
+
+  boost::crc_32_type crc;
+  char buffer[64 * 1024];
+  while (in) {
+    in.read(buffer, sizeof(buffer));
+    crc.process_bytes(buffer, static_cast<size_t>(in.gcount()));
+  }
+
+  return crc.checksum();
+}
+
+PluginKey getKey(GameType gameType, const fs::path& path, uint32_t crc) {
+  return PluginKey(
+      gameType, boost::to_lower_copy(path.filename().string()), crc);
+}
+
+bool isLoadOrderTimestampBased(GameType gameType) {
+  return gameType == GameType::tes4 || gameType == GameType::fo3 ||
+         gameType == GameType::fonv;
+}
+
+// Hard links save time and space, but can't be used where the load order is
+// set using timestamps, as the links would share them.
+void stageFile(const fs::path& from, const fs::path& to, bool allowLink) {
+  if (allowLink) {
+    boost::system::error_code ec;
+    fs::create_hard_link(from, to, ec);
+    if (!ec)
+      return;
+  }
+
+  fs::copy_file(from, to, fs::copy_option::overwrite_if_exists);
+}
+
+// A game handle can only hold one plugin of each name, so distinct plugins
+// that share a name are parsed in separate layers, each through its own
+// handle.
+ParsedPlugins parseLayer(
+    GameType gameType,
+    const std::vector<std::pair<PluginKey, fs::path>>& plugins,
+    const fs::path& layerPath) {
+  ParsedPlugins parsed;
+  try {
+    fs::create_directories(layerPath / "Data");
+    fs::create_directories(layerPath / "local");
+
+    std::vector<std::string> names;
+    for (const auto& plugin : plugins) {
+      auto name = plugin.second.filename().string();
+      stageFile(plugin.second, layerPath / "Data" / name, true);
+      names.push_back(name);
+    }
+
+    auto handle = CreateGameHandle(
+        gameType, layerPath.string(), (layerPath / "local").string());
+    handle->LoadPlugins(names, true);
+
+    for (const auto& plugin : plugins) {
+      auto loaded = handle->GetPlugin(plugin.second.filename().string());
+      if (loaded)
+        parsed.emplace(plugin.first, loaded);
+    }
+  } catch (std::exception& e) {
+    // Modlists with plugins that weren't parsed here load them themselves.
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Failed to parse the plugins in {}. Details: {}",
+                    layerPath.string(),
+                    e.what());
+    }
+  }
+
+  return parsed;
+}
+
+ParsedPlugins parsePlugins(const std::map<PluginKey, fs::path>& plugins,
+                           const fs::path& storePath) {
+  PhaseTimer timer("parseUniquePlugins");
+
+  std::map<std::pair<GameType, std::string>, size_t> nameCounts;
+  std::map<std::pair<GameType, size_t>,
+           std::vector<std::pair<PluginKey, fs::path>>>
+      layers;
+  for (const auto& plugin : plugins) {
+    auto& count = nameCounts[std::make_pair(std::get<0>(plugin.first),
+                                            std::get<1>(plugin.first))];
+    layers[std::make_pair(std::get<0>(plugin.first), count)].push_back(
+        plugin);
+    ++count;
+  }
+
+  std::vector<std::future<ParsedPlugins>> futures;
+  for (const auto& layer : layers) {
+    auto layerPath = storePath / std::to_string(futures.size());
+    futures.push_back(std::async(std::launch::async, [&layer, layerPath]() {
+      return parseLayer(layer.first.first, layer.second, layerPath);
+    }));
+  }
+
+  ParsedPlugins parsed;
+  for (auto& future : futures) {
+    auto layerPlugins = future.get();
+    parsed.insert(begin(layerPlugins), end(layerPlugins));
+  }
+
+  return parsed;
+}
+
+// Writes which plugins are active in the form that the game expects. Their
+// load order is set separately.
+void writeActivePlugins(GameType gameType,
+                        const fs::path& localPath,
+                        const std::vector<ModlistPlugin>& plugins) {
+  fs::ofstream out(localPath / "plugins.txt");
+  for (const auto& plugin : plugins) {
+    if (gameType == GameType::fo4 || gameType == GameType::tes5se) {
+      if (plugin.isActive)
+        out << '*';
+    } else if (!plugin.isActive)
+      continue;
+
+    out << plugin.path.filename().string() << std::endl;
+  }
+}
+
+ModlistReport checkModlist(const ModlistManifest& manifest,
+                           const fs::path& installPath,
+                           const PluginFiles& files,
+                           const ParsedPlugins& parsedPlugins,
+                           const ModlistBatchOptions& options) {
+  auto start = std::chrono::steady_clock::now();
+
+  ModlistReport report;
+  report.name = manifest.name;
+
+  try {
+    const auto gameType = manifest.gameSettings.Type();
+    const auto folderName = manifest.gameSettings.FolderName();
+    const auto gamePath = installPath / "game";
+    const auto localPath = installPath / "local";
+    const auto lootDataPath = installPath / "LOOT";
+
+    fs::remove_all(installPath);
+    fs::create_directories(gamePath / "Data");
+    fs::create_directories(localPath);
+    fs::create_directories(lootDataPath / folderName);
+
+    // Game detection also checks for these games' executables.
+    if (gameType == GameType::tes5)
+      fs::ofstream(gamePath / "TESV.exe");
+    else if (gameType == GameType::tes5se)
+      fs::ofstream(gamePath / "SkyrimSE.exe");
+
+    std::vector<std::string> loadOrder;
+    std::unordered_set<std::string> pluginNames;
+    std::vector<std::shared_ptr<const PluginInterface>> plugins;
+    for (const auto& plugin : manifest.plugins) {
+      auto error = files.errors.find(plugin.path);
+      if (error != files.errors.end())
+        throw std::runtime_error(error->second);
+
+      auto name = plugin.path.filename().string();
+      if (!pluginNames.insert(boost::to_lower_copy(name)).second)
+        throw std::invalid_argument("\"" + name + "\" is listed twice.");
+
+      stageFile(plugin.path,
+                gamePath / "Data" / name,
+                !isLoadOrderTimestampBased(gameType));
+      loadOrder.push_back(name);
+
+      auto parsed = parsedPlugins.find(
+          getKey(gameType, plugin.path, files.crcs.at(plugin.path)));
+      if (parsed != parsedPlugins.end())
+        plugins.push_back(parsed->second);
+    }
+    writeActivePlugins(gameType, localPath, manifest.plugins);
+
+    // All the modlists for a game use the same metadata.
+    for (const auto& filename : {"masterlist.yaml", "userlist.yaml"}) {
+      auto path = options.lootDataPath / folderName / filename;
+      if (fs::exists(path))
+        stageFile(path, lootDataPath / folderName / filename, true);
+    }
+
+    GameSettings gameSettings(manifest.gameSettings);
+    gameSettings.SetGamePath(gamePath);
+    Game game(gameSettings, lootDataPath, localPath);
+    game.Init();
+    game.SetLoadOrder(loadOrder);
+    if (plugins.size() == loadOrder.size())
+      game.ShareLoadedPlugins(plugins, false);
+    else
+      game.LoadAllInstalledPlugins(true);
+    game.LoadMetadata();
+
+    // Check the load order as given before sorting changes it.
+    for (const auto& name : loadOrder) {
+      auto plugin = game.GetPlugin(name);
+      if (!plugin)
+        continue;
+
+      for (const auto& master : plugin->GetMasters()) {
+        if (pluginNames.count(boost::to_lower_copy(master)) == 0)
+          report.missingMasters.push_back(MissingMaster{name, master});
+      }
+    }
+    report.violations = game.CheckLoadOrder();
+
+    report.sortedLoadOrder = game.SortPlugins();
+    if (report.sortedLoadOrder.empty()) {
+      for (const auto& message : game.GetMessages()) {
+        auto simpleMessage = message.ToSimpleMessage(options.language);
+        if (simpleMessage.type == MessageType::error)
+          report.sortErrors.push_back(simpleMessage.text);
+      }
+
+      if (report.sortErrors.empty()) {
+        report.sortErrors.push_back(
+            boost::locale::translate(
+                "Failed to sort plugins. Check the log for details.")
+                .str());
+      }
+    } else {
+      std::unordered_map<std::string, size_t> sortedPositions;
+      for (size_t i = 0; i < report.sortedLoadOrder.size(); ++i) {
+        sortedPositions.emplace(
+            boost::to_lower_copy(report.sortedLoadOrder[i]), i);
+      }
+
+      for (size_t i = 0; i < loadOrder.size(); ++i) {
+        auto it = sortedPositions.find(boost::to_lower_copy(loadOrder[i]));
+        if (it != sortedPositions.end() && it->second != i) {
+          report.loadOrderDifferences.push_back(
+              LoadOrderDifference{loadOrder[i], i, it->second});
+        }
+      }
+    }
+
+    report.isValid = report.missingMasters.empty() &&
+                     report.violations.empty() && report.sortErrors.empty();
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Checking the modlist \"{}\" failed. Details: {}",
+                    manifest.name,
+                    e.what());
+    }
+    report.error = e.what();
+    report.isValid = false;
+  }
+
+  boost::system::error_code ec;
+  fs::remove_all(installPath, ec);
+
+  report.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  return report;
+}
+}
+
+ModlistBatchOptions::ModlistBatchOptions() :
+    threads(0),
+    language(MessageContent::defaultLanguage) {}
+
+ModlistReport::ModlistReport() : isValid(false), duration(0) {}
+
+ModlistBatchResult::ModlistBatchResult() :
+    pluginFileCount(0),
+    uniquePluginCount(0),
+    duration(0) {}
+
+ModlistBatchResult runModlistBatch(
+    const std::vector<ModlistManifest>& manifests,
+    const ModlistBatchOptions& options) {
+  auto start = std::chrono::steady_clock::now();
+  const unsigned int threads =
+      options.threads > 0 ? options.threads
+                          : std::max(1u, std::thread::hardware_concurrency());
+
+  ModlistBatchResult result;
+
+  // Modlists often share most of their plugins, so only read each file once.
+  std::vector<fs::path> paths;
+  {
+    std::set<fs::path> seenPaths;
+    for (const auto& manifest : manifests) {
+      for (const auto& plugin : manifest.plugins) {
+        ++result.pluginFileCount;
+        if (seenPaths.insert(plugin.path).second)
+          paths.push_back(plugin.path);
+      }
+    }
+  }
+
+  std::vector<uint32_t> crcs(paths.size(), 0);
+  std::vector<std::string> errors(paths.size());
+  {
+    PhaseTimer timer("calculateCrcs");
+    parallelFor(paths.size(), threads, [&](size_t i) {
+      try {
+        crcs[i] = calculateCrc(paths[i]);
+      } catch (std::exception& e) {
+        errors[i] = e.what();
+      }
+    });
+  }
+
+  PluginFiles files;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (errors[i].empty())
+      files.crcs.emplace(paths[i], crcs[i]);
+    else
+      files.errors.emplace(paths[i], errors[i]);
+  }
+
+  std::map<PluginKey, fs::path> uniquePlugins;
+  for (const auto& manifest : manifests) {
+    for (const auto& plugin : manifest.plugins) {
+      auto crc = files.crcs.find(plugin.path);
+      if (crc != files.crcs.end()) {
+        uniquePlugins.emplace(
+            getKey(manifest.gameSettings.Type(), plugin.path, crc->second),
+            plugin.path);
+      }
+    }
+  }
+  result.uniquePluginCount = uniquePlugins.size();
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("Checking {} modlists with {} plugin files, of which {} "
+                 "are distinct.",
+                 manifests.size(),
+                 result.pluginFileCount,
+                 result.uniquePluginCount);
+  }
+
+  const auto storePath = options.workPath / "plugins";
+  auto parsedPlugins = parsePlugins(uniquePlugins, storePath);
+
+  result.reports.resize(manifests.size());
+  parallelFor(manifests.size(), threads, [&](size_t i) {
+    result.reports[i] =
+        checkModlist(manifests[i],
+                     options.workPath / "modlists" / std::to_string(i),
+                     files,
+                     parsedPlugins,
+                     options);
+  });
+
+  boost::system::error_code ec;
+  fs::remove_all(storePath, ec);
+
+  result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  return result;
+}
+}
+}
@@ -0,0 +1,125 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_MODLIST_BATCH
+#define LOOT_GUI_STATE_MODLIST_BATCH
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gui/state/game.h"
+#include "gui/state/game_settings.h"
+
+namespace loot {
+namespace gui {
+struct ModlistPlugin {
+  boost::filesystem::path path;
+  bool isActive;
+};
+
+// A modlist's plugin files and the load order they should be in, e.g. as
+// published for a community modlist.
+struct ModlistManifest {
+  std::string name;
+  // The game that the modlist is for. Its game path is ignored.
+  GameSettings gameSettings;
+  // The plugins, in load order.
+  std::vector<ModlistPlugin> plugins;
+};
+
+struct ModlistBatchOptions {
+  ModlistBatchOptions();
+
+  // Where the modlists' installs are staged while they're checked. Files in
+  // it may be overwritten or removed.
+  boost::filesystem::path workPath;
+  // The LOOT data folder that holds the masterlists and userlists to use.
+  boost::filesystem::path lootDataPath;
+  // The number of modlists that are checked at once. If zero, one modlist is
+  // checked per hardware thread.
+  unsigned int threads;
+  // The language that messages are given in.
+  std::string language;
+};
+
+struct MissingMaster {
+  std::string plugin;
+  std::string master;
+};
+
+// A plugin that the modlist puts in a different position than sorting does.
+struct LoadOrderDifference {
+  std::string plugin;
+  size_t position;
+  size_t sortedPosition;
+};
+
+struct ModlistReport {
+  ModlistReport();
+
+  std::string name;
+  // Empty unless the modlist couldn't be checked, in which case the rest of
+  // the report may be incomplete.
+  std::string error;
+  std::vector<MissingMaster> missingMasters;
+  // Plugins that the modlist loads before plugins they must load after.
+  std::vector<LoadOrderViolation> violations;
+  // Why sorting failed, e.g. because of a cyclic interaction. Empty if
+  // sorting succeeded.
+  std::vector<std::string> sortErrors;
+  std::vector<std::string> sortedLoadOrder;
+  std::vector<LoadOrderDifference> loadOrderDifferences;
+  // True if the modlist could be checked and sorted, and has no missing
+  // masters or load order violations. Load order differences are allowed.
+  bool isValid;
+  std::chrono::milliseconds duration;
+};
+
+struct ModlistBatchResult {
+  ModlistBatchResult();
+
+  // In the same order as the manifests.
+  std::vector<ModlistReport> reports;
+  // The number of plugin files that the manifests list, and how many of them
+  // have distinct names and content.
+  size_t pluginFileCount;
+  size_t uniquePluginCount;
+  std::chrono::milliseconds duration;
+};
+
+// Checks the load orders of many modlists at once. Plugin files that are
+// identical across modlists are found by their CRCs, and each distinct plugin
+// is only read once for the checks that don't need sorting, which are done
+// on the modlists' load orders as given. Each modlist is then staged as its
+// own install and sorted, several at a time.
+ModlistBatchResult runModlistBatch(
+    const std::vector<ModlistManifest>& manifests,
+    const ModlistBatchOptions& options);
+}
+}
+
+#endif
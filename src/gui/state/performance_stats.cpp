@@ -0,0 +1,134 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/performance_stats.h"
+
+#include <algorithm>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+namespace gui {
+namespace {
+double toMilliseconds(PhaseTimings::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+}
+
+thread_local PhaseTimings* PhaseTimings::current_ = nullptr;
+
+PhaseTimings::Scope::Scope(PhaseTimings& timings) : previous_(current_) {
+  current_ = &timings;
+}
+
+PhaseTimings::Scope::~Scope() { current_ = previous_; }
+
+void PhaseTimings::Add(const std::string& phase, Duration duration) {
+  auto it = std::find_if(phases_.begin(),
+                         phases_.end(),
+                         [&](const Phase& item) { return item.name == phase; });
+  if (it == phases_.end()) {
+    phases_.push_back(Phase{phase, duration, 1});
+  } else {
+    it->duration += duration;
+    ++it->count;
+  }
+}
+
+const std::vector<PhaseTimings::Phase>& PhaseTimings::GetPhases() const {
+  return phases_;
+}
+
+PhaseTimings* PhaseTimings::Current() { return current_; }
+
+PhaseTimer::PhaseTimer(const std::string& phase) :
+    timings_(PhaseTimings::Current()) {
+  // Avoid any cost when nothing is being recorded.
+  if (timings_ != nullptr) {
+    phase_ = phase;
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+PhaseTimer::~PhaseTimer() {
+  if (timings_ != nullptr)
+    timings_->Add(phase_, std::chrono::steady_clock::now() - start_);
+}
+
+PerformanceStats::PerformanceStats(size_t maxRecentExecutions) :
+    maxRecentExecutions_(maxRecentExecutions) {}
+
+void PerformanceStats::Record(const std::string& name,
+                              PhaseTimings::Duration duration,
+                              size_t responseSize,
+                              const PhaseTimings& timings) {
+  auto logger = getLogger();
+  if (logger) {
+    std::string phases;
+    for (const auto& phase : timings.GetPhases()) {
+      phases += fmt::format(
+          ", {}: {:.1f} ms", phase.name, toMilliseconds(phase.duration));
+      if (phase.count > 1)
+        phases += fmt::format(" ({} times)", phase.count);
+    }
+    logger->info("{} took {:.1f} ms and gave a {} byte response{}",
+                 name,
+                 toMilliseconds(duration),
+                 responseSize,
+                 phases);
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  recentExecutions_.push_front(
+      Execution{name, duration, responseSize, timings.GetPhases()});
+  if (recentExecutions_.size() > maxRecentExecutions_)
+    recentExecutions_.pop_back();
+
+  auto it = std::lower_bound(
+      totals_.begin(), totals_.end(), name, [](const Total& total,
+                                               const std::string& name) {
+        return total.name < name;
+      });
+  if (it == totals_.end() || it->name != name) {
+    totals_.insert(it, Total{name, 1, duration, duration});
+  } else {
+    ++it->count;
+    it->duration += duration;
+    it->maxDuration = std::max(it->maxDuration, duration);
+  }
+}
+
+std::vector<PerformanceStats::Execution> PerformanceStats::GetRecentExecutions()
+    const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return std::vector<Execution>(recentExecutions_.begin(),
+                                recentExecutions_.end());
+}
+
+std::vector<PerformanceStats::Total> PerformanceStats::GetTotals() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return totals_;
+}
+}
+}
@@ -0,0 +1,124 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_PERFORMANCE_STATS
+#define LOOT_GUI_STATE_PERFORMANCE_STATS
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace loot {
+namespace gui {
+// The time spent in each named phase of a piece of work. Phases with the same
+// name are added together. Phases may be nested in or overlap each other.
+class PhaseTimings {
+public:
+  typedef std::chrono::steady_clock::duration Duration;
+
+  struct Phase {
+    std::string name;
+    Duration duration;
+    size_t count;
+  };
+
+  // Makes the given timings the ones that PhaseTimer records to on the
+  // current thread, for as long as the scope exists.
+  class Scope {
+  public:
+    explicit Scope(PhaseTimings& timings);
+    ~Scope();
+
+  private:
+    PhaseTimings* previous_;
+  };
+
+  void Add(const std::string& phase, Duration duration);
+  const std::vector<Phase>& GetPhases() const;
+
+  // Returns nullptr if no timings are being recorded on the current thread.
+  static PhaseTimings* Current();
+
+private:
+  std::vector<Phase> phases_;
+
+  static thread_local PhaseTimings* current_;
+};
+
+// Times the phase that it is in scope for, and adds it to the current
+// thread's timings, if there are any.
+class PhaseTimer {
+public:
+  explicit PhaseTimer(const std::string& phase);
+  ~PhaseTimer();
+
+private:
+  PhaseTimings* timings_;
+  std::string phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Collects the timings of recent query executions, and totals for each type
+// of query. Safe to use from any thread.
+class PerformanceStats {
+public:
+  struct Execution {
+    std::string name;
+    PhaseTimings::Duration duration;
+    size_t responseSize;
+    std::vector<PhaseTimings::Phase> phases;
+  };
+
+  struct Total {
+    std::string name;
+    size_t count;
+    PhaseTimings::Duration duration;
+    PhaseTimings::Duration maxDuration;
+  };
+
+  explicit PerformanceStats(size_t maxRecentExecutions = 20);
+
+  // Also logs the execution at info level.
+  void Record(const std::string& name,
+              PhaseTimings::Duration duration,
+              size_t responseSize,
+              const PhaseTimings& timings);
+
+  // Most recent first.
+  std::vector<Execution> GetRecentExecutions() const;
+  // Sorted by name.
+  std::vector<Total> GetTotals() const;
+
+private:
+  const size_t maxRecentExecutions_;
+  std::deque<Execution> recentExecutions_;
+  std::vector<Total> totals_;
+  mutable std::mutex mutex_;
+};
+}
+}
+
+#endif
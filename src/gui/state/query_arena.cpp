@@ -0,0 +1,112 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/query_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "gui/state/memory_usage.h"
+
+namespace loot {
+namespace gui {
+namespace {
+// Blocks don't grow past this, so that a query that allocates a lot doesn't
+// reserve much more than it uses.
+constexpr size_t maxBlockSize = 4 * 1024 * 1024;
+}
+
+// A block's header is followed by its data, which is aligned for any type.
+struct alignas(std::max_align_t) QueryArena::Block {
+  Block* previous;
+  size_t size;
+};
+
+thread_local QueryArena* QueryArena::current_ = nullptr;
+
+QueryArena::QueryArena(size_t initialBlockSize) :
+    initialBlockSize_(std::max<size_t>(initialBlockSize, 1)),
+    nextBlockSize_(initialBlockSize_),
+    bytesReserved_(0),
+    block_(nullptr),
+    next_(nullptr),
+    end_(nullptr) {}
+
+QueryArena::~QueryArena() { Release(); }
+
+QueryArena::Scope::Scope(QueryArena& arena) : previous_(current_) {
+  current_ = &arena;
+}
+
+QueryArena::Scope::~Scope() { current_ = previous_; }
+
+void* QueryArena::Allocate(size_t bytes, size_t alignment) {
+  const uintptr_t mask = alignment - 1;
+  uintptr_t aligned = (reinterpret_cast<uintptr_t>(next_) + mask) & ~mask;
+  if (block_ == nullptr ||
+      aligned + bytes > reinterpret_cast<uintptr_t>(end_)) {
+    AddBlock(bytes + alignment);
+    aligned = (reinterpret_cast<uintptr_t>(next_) + mask) & ~mask;
+  }
+
+  next_ = reinterpret_cast<char*>(aligned + bytes);
+  return reinterpret_cast<void*>(aligned);
+}
+
+void QueryArena::Release() {
+  while (block_ != nullptr) {
+    auto previous = block_->previous;
+    MemoryCounters::Deallocate(MemorySubsystem::queryArenas,
+                               sizeof(Block) + block_->size);
+    ::operator delete(block_);
+    block_ = previous;
+  }
+
+  nextBlockSize_ = initialBlockSize_;
+  bytesReserved_ = 0;
+  next_ = nullptr;
+  end_ = nullptr;
+}
+
+size_t QueryArena::GetBytesReserved() const { return bytesReserved_; }
+
+QueryArena* QueryArena::Current() { return current_; }
+
+void QueryArena::AddBlock(size_t minimumSize) {
+  const size_t size = std::max(nextBlockSize_, minimumSize);
+  const size_t totalSize = sizeof(Block) + size;
+
+  auto block = static_cast<Block*>(::operator new(totalSize));
+  block->previous = block_;
+  block->size = size;
+  MemoryCounters::Allocate(MemorySubsystem::queryArenas, totalSize);
+
+  block_ = block;
+  next_ = reinterpret_cast<char*>(block + 1);
+  end_ = next_ + size;
+  bytesReserved_ += totalSize;
+  nextBlockSize_ = std::min(nextBlockSize_ * 2, maxBlockSize);
+}
+}
+}
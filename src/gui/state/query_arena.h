@@ -0,0 +1,137 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_QUERY_ARENA
+#define LOOT_GUI_STATE_QUERY_ARENA
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace loot {
+namespace gui {
+// A monotonic arena for the temporaries that a query allocates while it runs.
+// Allocating bumps a pointer within the arena's current block, deallocating
+// does nothing, and all the arena's blocks are freed together when it is
+// released or destroyed. Its blocks are counted as the queryArenas memory
+// subsystem. Not safe to use from more than one thread at a time.
+class QueryArena {
+public:
+  explicit QueryArena(size_t initialBlockSize = 64 * 1024);
+  ~QueryArena();
+
+  QueryArena(const QueryArena&) = delete;
+  QueryArena& operator=(const QueryArena&) = delete;
+
+  // Makes the given arena the one that ArenaAllocators use by default on the
+  // current thread, for as long as the scope exists.
+  class Scope {
+  public:
+    explicit Scope(QueryArena& arena);
+    ~Scope();
+
+  private:
+    QueryArena* previous_;
+  };
+
+  void* Allocate(size_t bytes, size_t alignment);
+
+  // Frees all the arena's blocks. Anything allocated from the arena must
+  // already have been destroyed.
+  void Release();
+
+  // The size of all the arena's blocks, including any space not yet used.
+  size_t GetBytesReserved() const;
+
+  // Returns nullptr if no arena is in scope on the current thread.
+  static QueryArena* Current();
+
+private:
+  struct Block;
+
+  void AddBlock(size_t minimumSize);
+
+  const size_t initialBlockSize_;
+  size_t nextBlockSize_;
+  size_t bytesReserved_;
+  Block* block_;
+  char* next_;
+  char* end_;
+
+  static thread_local QueryArena* current_;
+};
+
+// An allocator that allocates from the arena it was constructed with, or
+// from the heap if that is nullptr. Default-constructed allocators use the
+// current thread's arena, so containers that use this allocator must not
+// outlive the query that created them. Copies of a container use the same
+// arena as the original.
+template <typename T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  ArenaAllocator() noexcept : arena_(QueryArena::Current()) {}
+  explicit ArenaAllocator(QueryArena* arena) noexcept : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept :
+      arena_(other.GetArena()) {}
+
+  T* allocate(size_t count) {
+    if (arena_ == nullptr)
+      return std::allocator<T>().allocate(count);
+
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+
+    return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, size_t count) noexcept {
+    if (arena_ == nullptr)
+      std::allocator<T>().deallocate(pointer, count);
+  }
+
+  QueryArena* GetArena() const noexcept { return arena_; }
+
+private:
+  QueryArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs,
+                const ArenaAllocator<U>& rhs) noexcept {
+  return lhs.GetArena() == rhs.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs,
+                const ArenaAllocator<U>& rhs) noexcept {
+  return !(lhs == rhs);
+}
+}
+}
+
+#endif
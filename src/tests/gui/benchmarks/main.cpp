@@ -0,0 +1,250 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/locale.hpp>
+
+#include "gui/cef/query/json.h"
+#include "gui/state/game.h"
+#include "tests/gui/benchmarks/synthetic_install.h"
+
+namespace {
+using loot::DerivedPluginMetadata;
+using loot::MessageContent;
+using loot::PluginInterface;
+using loot::PluginMetadata;
+using loot::gui::Game;
+using loot::test::SyntheticInstall;
+
+// Durations in milliseconds, in the order the operations were first timed.
+typedef std::vector<std::pair<std::string, std::vector<double>>> Timings;
+
+template<typename Function>
+void timeOperation(Timings& timings,
+                   const std::string& name,
+                   Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  std::chrono::duration<double, std::milli> duration =
+      std::chrono::steady_clock::now() - start;
+
+  auto it = std::find_if(
+      timings.begin(),
+      timings.end(),
+      [&](const Timings::value_type& timing) { return timing.first == name; });
+  if (it == timings.end()) {
+    timings.emplace_back(name, std::vector<double>());
+    it = timings.end() - 1;
+  }
+  it->second.push_back(duration.count());
+}
+
+// Mirrors MetadataQuery::generateDerivedMetadata(), which can't be used
+// without the rest of LOOT's state.
+DerivedPluginMetadata deriveMetadata(
+    Game& game,
+    const std::shared_ptr<const PluginInterface>& plugin) {
+  auto masterlistMetadata = game.GetMasterlistMetadata(plugin->GetName());
+  auto userlistMetadata = game.GetUserMetadata(plugin->GetName());
+
+  auto evaluatedMetadata = game.GetMasterlistMetadata(plugin->GetName(), true);
+
+  auto fileTags = plugin->GetBashTags();
+  auto tags = evaluatedMetadata.GetTags();
+  tags.insert(begin(fileTags), end(fileTags));
+  evaluatedMetadata.SetTags(tags);
+
+  auto messages = evaluatedMetadata.GetMessages();
+  auto validityMessages =
+      game.CheckInstallValidity(plugin, evaluatedMetadata);
+  messages.insert(
+      end(messages), begin(validityMessages), end(validityMessages));
+  evaluatedMetadata.SetMessages(messages);
+
+  evaluatedMetadata.MergeMetadata(
+      game.GetUserMetadata(plugin->GetName(), true));
+
+  DerivedPluginMetadata derived(*game.GetSnapshot(),
+                                MessageContent::defaultLanguage,
+                                plugin,
+                                evaluatedMetadata);
+  derived.storeUnevaluatedMetadata(masterlistMetadata, userlistMetadata);
+
+  return derived;
+}
+
+// Runs each operation once on a freshly constructed game, so that nothing is
+// reused from previous repetitions apart from what's stored on disk between
+// sessions, which is deleted first.
+void runRepetition(const SyntheticInstall& install, Timings& timings) {
+  auto gameLootDataPath =
+      install.LootDataPath() / install.GetGameSettings().FolderName();
+  boost::filesystem::remove(gameLootDataPath / "sorted.txt");
+  boost::filesystem::remove(gameLootDataPath / "formids.bin");
+
+  Game game(install.GetGameSettings(),
+            install.LootDataPath(),
+            install.LocalPath());
+  game.Init();
+
+  timeOperation(timings, "LoadAllInstalledPlugins (headers)", [&]() {
+    game.LoadAllInstalledPlugins(true);
+  });
+  timeOperation(timings, "LoadAllInstalledPlugins (full)", [&]() {
+    game.LoadAllInstalledPlugins(false);
+  });
+  timeOperation(timings, "LoadMetadata", [&]() { game.LoadMetadata(); });
+  timeOperation(
+      timings, "UpdateFormIdIndex", [&]() { game.UpdateFormIdIndex(); });
+  timeOperation(timings, "SortPlugins", [&]() { game.SortPlugins(); });
+  timeOperation(
+      timings, "SortPlugins (stored result)", [&]() { game.SortPlugins(); });
+  timeOperation(timings, "CheckLoadOrder", [&]() { game.CheckLoadOrder(); });
+
+  std::vector<std::shared_ptr<const PluginInterface>> plugins;
+  std::vector<PluginMetadata> masterlistMetadata;
+  for (const auto& name : game.GetLoadOrder()) {
+    auto plugin = game.GetPlugin(name);
+    if (plugin) {
+      plugins.push_back(plugin);
+      masterlistMetadata.push_back(game.GetMasterlistMetadata(name, true));
+    }
+  }
+
+  timeOperation(timings, "CheckInstallValidity", [&]() {
+    for (size_t i = 0; i < plugins.size(); ++i) {
+      game.CheckInstallValidity(plugins[i], masterlistMetadata[i]);
+    }
+  });
+
+  std::vector<DerivedPluginMetadata> derivedMetadata;
+  timeOperation(timings, "Derive plugin metadata", [&]() {
+    for (const auto& plugin : plugins) {
+      derivedMetadata.push_back(deriveMetadata(game, plugin));
+    }
+  });
+
+  std::string response;
+  timeOperation(timings, "Serialise plugins JSON", [&]() {
+    nlohmann::json json = derivedMetadata;
+    response = json.dump();
+  });
+}
+
+void printTimings(size_t pluginCount, Timings& timings) {
+  std::cout << std::endl
+            << pluginCount << " plugins" << std::endl
+            << std::left << std::setw(36) << "Operation" << std::right
+            << std::setw(12) << "Min (ms)" << std::setw(12) << "Median (ms)"
+            << std::setw(12) << "Max (ms)" << std::endl;
+
+  std::cout << std::fixed << std::setprecision(2);
+  for (auto& timing : timings) {
+    auto& durations = timing.second;
+    std::sort(durations.begin(), durations.end());
+
+    std::cout << std::left << std::setw(36) << timing.first << std::right
+              << std::setw(12) << durations.front() << std::setw(12)
+              << durations[durations.size() / 2] << std::setw(12)
+              << durations.back() << std::endl;
+  }
+}
+
+void printUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--plugins 100,1000,5000] [--repetitions 3]"
+               " [--path <directory>] [--keep]"
+            << std::endl;
+}
+}
+
+int main(int argc, char** argv) {
+  // Set the locale to get encoding conversions working correctly.
+  std::locale::global(boost::locale::generator().generate(""));
+  boost::filesystem::path::imbue(std::locale());
+  loot::InitialiseLocale("");
+
+  // Disable logging or else it will be included in the timings.
+  loot::SetLoggingCallback([&](loot::LogLevel level, const char* message) {});
+
+  std::vector<size_t> pluginCounts({100, 1000, 5000});
+  size_t repetitions = 3;
+  boost::filesystem::path path =
+      boost::filesystem::temp_directory_path() / "loot_gui_benchmarks";
+  bool keep = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--keep") {
+      keep = true;
+    } else if (i + 1 < argc && arg == "--plugins") {
+      std::vector<std::string> counts;
+      boost::split(counts, argv[++i], boost::is_any_of(","));
+      pluginCounts.clear();
+      for (const auto& count : counts) {
+        pluginCounts.push_back(std::strtoul(count.c_str(), nullptr, 10));
+      }
+    } else if (i + 1 < argc && arg == "--repetitions") {
+      repetitions = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+    } else if (i + 1 < argc && arg == "--path") {
+      path = argv[++i];
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  try {
+    for (auto pluginCount : pluginCounts) {
+      SyntheticInstall install(path / std::to_string(pluginCount),
+                               pluginCount);
+
+      Timings timings;
+      timeOperation(timings, "Generate install", [&]() { install.Generate(); });
+      for (size_t i = 0; i < repetitions; ++i) {
+        runRepetition(install, timings);
+      }
+
+      printTimings(pluginCount, timings);
+    }
+  } catch (std::exception& e) {
+    std::cerr << "Benchmark failed: " << e.what() << std::endl;
+    return 1;
+  }
+
+  if (!keep)
+    boost::filesystem::remove_all(path);
+
+  return 0;
+}
@@ -0,0 +1,358 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_BENCHMARKS_SYNTHETIC_INSTALL
+#define LOOT_TESTS_GUI_BENCHMARKS_SYNTHETIC_INSTALL
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/format.hpp>
+
+#include "gui/state/game_settings.h"
+
+namespace loot {
+namespace test {
+// Writes a Skyrim Special Edition install with a large number of plugins,
+// and a masterlist and userlist for them, for benchmarking. The plugins are
+// valid but small: they have chains of masters, and each overrides some of
+// its masters' records so that plugins overlap. A few plugins are ghosted.
+// The same seed always generates the same install.
+class SyntheticInstall {
+public:
+  SyntheticInstall(const boost::filesystem::path& rootPath,
+                   size_t pluginCount,
+                   unsigned int seed = 1) :
+      gameSettings_(GameType::tes5se),
+      rootPath_(rootPath),
+      pluginCount_(pluginCount),
+      random_(seed) {
+    gameSettings_.SetGamePath(rootPath_ / "game");
+  }
+
+  const GameSettings& GetGameSettings() const { return gameSettings_; }
+  boost::filesystem::path DataPath() const {
+    return gameSettings_.GamePath() / "Data";
+  }
+  boost::filesystem::path LocalPath() const { return rootPath_ / "local"; }
+  boost::filesystem::path LootDataPath() const { return rootPath_ / "LOOT"; }
+
+  // Replaces anything previously generated at the root path.
+  void Generate() {
+    boost::filesystem::remove_all(rootPath_);
+    boost::filesystem::create_directories(DataPath());
+    boost::filesystem::create_directories(LocalPath());
+    boost::filesystem::create_directories(LootDataPath() /
+                                          gameSettings_.FolderName());
+
+    // Game detection looks for the executable.
+    boost::filesystem::ofstream(gameSettings_.GamePath() / "SkyrimSE.exe");
+
+    PlanPlugins();
+    for (const auto& plugin : plugins_) {
+      WritePlugin(plugin);
+    }
+    WriteLoadOrder();
+    WriteMasterlist();
+    WriteUserlist();
+  }
+
+private:
+  struct Plugin {
+    std::string name;
+    bool isMaster;
+    bool isLight;
+    bool isGhosted;
+    bool isActive;
+    // Indices into plugins_, in the order the plugin lists them.
+    std::vector<size_t> masters;
+    uint32_t recordCount;
+  };
+
+  // Light plugins can only use object IDs 0x800 to 0xFFF.
+  static constexpr uint32_t firstObjectId_ = 0x800;
+  static constexpr uint32_t maxActiveFullPlugins_ = 250;
+
+  size_t RandomIndex(size_t count) { return random_() % count; }
+
+  bool RandomChance(unsigned int percent) {
+    return random_() % 100 < percent;
+  }
+
+  void PlanPlugins() {
+    plugins_.clear();
+
+    Plugin gameMaster;
+    gameMaster.name = gameSettings_.Master();
+    gameMaster.isMaster = true;
+    gameMaster.isLight = false;
+    gameMaster.isGhosted = false;
+    gameMaster.isActive = true;
+    gameMaster.recordCount = 2000;
+    plugins_.push_back(gameMaster);
+
+    // Masters have to load before other plugins, so plan them in load order:
+    // a tenth of the plugins are masters, a tenth are light masters, and the
+    // rest are normal plugins.
+    const size_t masterCount = pluginCount_ / 10;
+    const size_t lightCount = pluginCount_ / 10;
+    size_t activeFullPlugins = 1;
+    std::vector<size_t> masterIndices(1, 0);
+
+    for (size_t i = 0; i < pluginCount_; ++i) {
+      Plugin plugin;
+      plugin.isMaster = i < masterCount + lightCount;
+      plugin.isLight = plugin.isMaster && i >= masterCount;
+      plugin.isGhosted = !plugin.isMaster && i % 25 == 0;
+      plugin.recordCount = plugin.isLight ? 16 : 64;
+      plugin.masters.push_back(0);
+
+      std::string extension =
+          plugin.isLight ? ".esl" : (plugin.isMaster ? ".esm" : ".esp");
+      plugin.name =
+          (boost::format("Synthetic %05u%s") % i % extension).str();
+
+      // Chain plugins onto the plugin before them of the same kind, and add
+      // a couple of other earlier masters.
+      size_t previous = plugins_.size() - 1;
+      if (previous > 0 && RandomChance(50) &&
+          plugins_[previous].isMaster == plugin.isMaster) {
+        plugin.masters.push_back(previous);
+      }
+      for (int j = 0; j < 2 && masterIndices.size() > 1; ++j) {
+        if (!RandomChance(60))
+          continue;
+        size_t master =
+            masterIndices[1 + RandomIndex(masterIndices.size() - 1)];
+        if (std::find(plugin.masters.begin(),
+                      plugin.masters.end(),
+                      master) == plugin.masters.end()) {
+          plugin.masters.push_back(master);
+        }
+      }
+
+      if (plugin.isLight) {
+        plugin.isActive = true;
+      } else {
+        plugin.isActive = activeFullPlugins < maxActiveFullPlugins_;
+        if (plugin.isActive)
+          ++activeFullPlugins;
+      }
+
+      if (plugin.isMaster)
+        masterIndices.push_back(plugins_.size());
+      plugins_.push_back(plugin);
+    }
+  }
+
+  static void AppendUInt(std::string& buffer, uint32_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  static void AppendSubrecord(std::string& buffer,
+                              const std::string& type,
+                              const std::string& data) {
+    buffer += type;
+    AppendUInt(buffer, static_cast<uint32_t>(data.size()), 2);
+    buffer += data;
+  }
+
+  static void AppendRecord(std::string& buffer,
+                           const std::string& type,
+                           uint32_t flags,
+                           uint32_t formId,
+                           const std::string& data) {
+    buffer += type;
+    AppendUInt(buffer, static_cast<uint32_t>(data.size()), 4);
+    AppendUInt(buffer, flags, 4);
+    AppendUInt(buffer, formId, 4);
+    AppendUInt(buffer, 0, 4);   // Version control info.
+    AppendUInt(buffer, 44, 2);  // Form version.
+    AppendUInt(buffer, 0, 2);
+    buffer += data;
+  }
+
+  void WritePlugin(const Plugin& plugin) {
+    std::string header;
+    std::string hedr;
+    AppendUInt(hedr, 0x3FD9999A, 4);  // 1.7 as a float.
+    AppendUInt(hedr, plugin.recordCount, 4);
+    AppendUInt(hedr, firstObjectId_ + plugin.recordCount, 4);
+    AppendSubrecord(header, "HEDR", hedr);
+    AppendSubrecord(header, "CNAM", std::string("LOOT", 5));
+    for (auto master : plugin.masters) {
+      AppendSubrecord(header, "MAST", plugins_[master].name + '\0');
+      AppendSubrecord(header, "DATA", std::string(8, '\0'));
+    }
+
+    uint32_t flags = 0;
+    if (plugin.isMaster)
+      flags |= 0x1;
+    if (plugin.isLight)
+      flags |= 0x200;
+
+    std::string records;
+    const uint32_t ownIndex = static_cast<uint32_t>(plugin.masters.size())
+                              << 24;
+    for (uint32_t i = 0; i < plugin.recordCount; ++i) {
+      std::string data;
+      AppendSubrecord(data,
+                      "EDID",
+                      (boost::format("Synthetic%08X") % (ownIndex | i)).str() +
+                          '\0');
+      AppendRecord(records, "MISC", 0, ownIndex | (firstObjectId_ + i), data);
+    }
+
+    // Override a few records from each master so that plugins overlap. None
+    // of the record counts are multiples of 7, so the IDs are distinct.
+    for (uint32_t i = 0; i < plugin.masters.size(); ++i) {
+      const auto& master = plugins_[plugin.masters[i]];
+      auto start = static_cast<uint32_t>(RandomIndex(master.recordCount));
+      for (uint32_t j = 0; j < 8; ++j) {
+        uint32_t objectId =
+            firstObjectId_ + (start + j * 7) % master.recordCount;
+        AppendRecord(records, "MISC", 0, (i << 24) | objectId, std::string());
+      }
+    }
+
+    std::string content;
+    AppendRecord(content, "TES4", flags, 0, header);
+    content += "GRUP";
+    AppendUInt(content, static_cast<uint32_t>(24 + records.size()), 4);
+    content += "MISC";
+    AppendUInt(content, 0, 4);  // Group type.
+    AppendUInt(content, 0, 4);  // Timestamp.
+    AppendUInt(content, 0, 4);  // Version control info.
+    content += records;
+
+    std::string filename = plugin.name;
+    if (plugin.isGhosted)
+      filename += ".ghost";
+    boost::filesystem::ofstream out(DataPath() / filename, std::ios::binary);
+    out.write(content.data(), content.size());
+  }
+
+  void WriteLoadOrder() const {
+    // The game master is implicitly active, and so isn't listed.
+    boost::filesystem::ofstream out(LocalPath() / "plugins.txt");
+    for (size_t i = 1; i < plugins_.size(); ++i) {
+      if (plugins_[i].isActive)
+        out << '*';
+      out << plugins_[i].name << std::endl;
+    }
+  }
+
+  // Earlier plugins of the same kind can be loaded after without causing a
+  // cycle. Falls back to the game master if there are none.
+  size_t EarlierPluginOfSameKind(size_t index) {
+    size_t earlier = 1 + RandomIndex(index - 1);
+    while (earlier < index &&
+           plugins_[earlier].isMaster != plugins_[index].isMaster) {
+      ++earlier;
+    }
+    return earlier < index ? earlier : 0;
+  }
+
+  void WriteMasterlist() {
+    boost::filesystem::ofstream out(LootDataPath() /
+                                    gameSettings_.FolderName() /
+                                    "masterlist.yaml");
+    out << "bash_tags: [ Delev, Relev, Invent, Names, Stats ]" << std::endl
+        << "globals:" << std::endl
+        << "  - type: say" << std::endl
+        << "    content: 'This is a synthetic install.'" << std::endl
+        << "    condition: 'file(\"" << plugins_.back().name << "\")'"
+        << std::endl
+        << "plugins:" << std::endl
+        << "  - name: 'Synthetic 0.*\\.esp'" << std::endl
+        << "    tag: [ Names ]" << std::endl;
+
+    for (size_t i = 2; i < plugins_.size(); ++i) {
+      if (i % 3 != 0)
+        continue;
+
+      const auto& plugin = plugins_[i];
+      out << "  - name: '" << plugin.name << "'" << std::endl;
+      out << "    after: [ '" << plugins_[EarlierPluginOfSameKind(i)].name
+          << "' ]" << std::endl;
+      if (i % 7 == 0) {
+        out << "    req: [ '" << plugins_[plugin.masters.back()].name << "' ]"
+            << std::endl;
+      }
+      if (i % 5 == 0) {
+        out << "    tag: [ Delev, -Relev ]" << std::endl;
+      }
+      if (i % 4 == 0) {
+        size_t other = 1 + RandomIndex(plugins_.size() - 1);
+        out << "    msg:" << std::endl
+            << "      - type: warn" << std::endl
+            << "        content: 'Incompatible with " << plugins_[other].name
+            << ".'" << std::endl
+            << "        condition: 'active(\"" << plugins_[other].name
+            << "\")'" << std::endl;
+      }
+      if (i % 11 == 0) {
+        out << "    dirty:" << std::endl
+            << "      - crc: 0x" << std::hex << random_() << std::dec
+            << std::endl
+            << "        util: 'SSEEdit'" << std::endl
+            << "        itm: 4" << std::endl;
+      }
+    }
+  }
+
+  void WriteUserlist() {
+    boost::filesystem::ofstream out(LootDataPath() /
+                                    gameSettings_.FolderName() /
+                                    "userlist.yaml");
+    out << "plugins:" << std::endl;
+    for (size_t i = 2; i < plugins_.size(); ++i) {
+      if (i % 10 == 0) {
+        out << "  - name: '" << plugins_[i].name << "'" << std::endl
+            << "    after: [ '" << plugins_[EarlierPluginOfSameKind(i)].name
+            << "' ]" << std::endl;
+      } else if (i % 45 == 0) {
+        out << "  - name: '" << plugins_[i].name << "'" << std::endl
+            << "    priority: 10" << std::endl;
+      }
+    }
+  }
+
+  GameSettings gameSettings_;
+  boost::filesystem::path rootPath_;
+  size_t pluginCount_;
+  std::mt19937 random_;
+  std::vector<Plugin> plugins_;
+};
+}
+}
+
+#endif
@@ -229,6 +229,69 @@ describe('Game', () => {
     });
   });
 
+  describe('#versions', () => {
+    it("should be a copy of the object's value if defined", () => {
+      const versions = { bashTags: '1', masterlist: '1' };
+      const game = new loot.Game({ versions }, l10n);
+
+      game.versions.should.deep.equal(versions);
+      game.versions.should.not.equal(versions);
+    });
+
+    it('should drop the masterlist version when masterlist is set', () => {
+      const game = new loot.Game(
+        { versions: { bashTags: '1', masterlist: '1' } },
+        l10n
+      );
+
+      game.masterlist = { revision: 'foo' };
+
+      game.versions.should.deep.equal({ bashTags: '1' });
+    });
+
+    it('should drop the general messages version when generalMessages is set', () => {
+      const game = new loot.Game(
+        { versions: { bashTags: '1', generalMessages: 'a' } },
+        l10n
+      );
+
+      game.generalMessages = [];
+
+      game.versions.should.deep.equal({ bashTags: '1' });
+    });
+  });
+
+  describe('#fillNotModifiedBlocks()', () => {
+    it('should copy blocks listed as not modified from the previous game', () => {
+      const previousGame = new loot.Game(
+        { bashTags: ['Delev'], masterlist: { revision: 'foo' } },
+        l10n
+      );
+      const gameInfo = {
+        folder: 'test',
+        masterlist: { revision: 'bar' },
+        notModified: ['bashTags']
+      };
+
+      const filled = loot.Game.fillNotModifiedBlocks(gameInfo, previousGame);
+
+      filled.should.deep.equal({
+        folder: 'test',
+        masterlist: { revision: 'bar' },
+        bashTags: ['Delev']
+      });
+    });
+
+    it('should not modify the given game info object', () => {
+      const previousGame = new loot.Game({ bashTags: ['Delev'] }, l10n);
+      const gameInfo = { notModified: ['bashTags'] };
+
+      loot.Game.fillNotModifiedBlocks(gameInfo, previousGame);
+
+      gameInfo.should.deep.equal({ notModified: ['bashTags'] });
+    });
+  });
+
   describe('#plugins', () => {
     let game;
     let handleEvent;
@@ -380,6 +443,72 @@ describe('Game', () => {
     });
   });
 
+  describe('#setSortedPluginMoves', () => {
+    let game;
+
+    beforeEach(() => {
+      game = new loot.Game({}, l10n);
+      game._plugins = [
+        new loot.Plugin({ name: 'foo' }),
+        new loot.Plugin({ name: 'bar' }),
+        new loot.Plugin({ name: 'baz' }),
+        new loot.Plugin({ name: 'qux' })
+      ];
+    });
+
+    it('should reorder plugins by making the given moves', () => {
+      game.setSortedPluginMoves([{ name: 'qux', from: 3, to: 1 }], []);
+
+      game.plugins
+        .map(plugin => plugin.name)
+        .should.deep.equal(['foo', 'qux', 'bar', 'baz']);
+    });
+
+    it('should update the given plugins with new data', () => {
+      game.setSortedPluginMoves([], [{ name: 'bar', crc: 0xdeadbeef }]);
+
+      game.plugins[1].crc.should.equal(0xdeadbeef);
+    });
+
+    it('should store the old load order and the moves', () => {
+      const oldPlugins = game.plugins;
+      const moves = [{ name: 'foo', from: 0, to: 3 }];
+
+      game.setSortedPluginMoves(moves, []);
+
+      game.oldLoadOrder.should.equal(oldPlugins);
+      game.sortMoves.should.equal(moves);
+    });
+
+    it('should return true if the moves were made', () => {
+      game
+        .setSortedPluginMoves([{ name: 'qux', from: 3, to: 1 }], [])
+        .should.equal(true);
+    });
+
+    it('should change nothing and return false if a move names a different plugin', () => {
+      const oldPlugins = game.plugins;
+
+      game
+        .setSortedPluginMoves([{ name: 'qux', from: 2, to: 1 }], [])
+        .should.equal(false);
+
+      game.plugins.should.equal(oldPlugins);
+      (game.oldLoadOrder === undefined).should.equal(true);
+      (game.sortMoves === undefined).should.equal(true);
+    });
+
+    it('should change nothing and return false if a move is out of range', () => {
+      game
+        .setSortedPluginMoves([{ name: 'qux', from: 3, to: 4 }], [])
+        .should.equal(false);
+
+      game.plugins
+        .map(plugin => plugin.name)
+        .should.deep.equal(['foo', 'bar', 'baz', 'qux']);
+    });
+  });
+
   describe('#setSortedPlugins', () => {
     let game;
     let handleEvent;
@@ -0,0 +1,24 @@
+'use strict';
+
+describe('subscribe()', () => {
+  it('should throw if no event handler is passed', () => {
+    (() => {
+      loot.subscribe();
+    }).should.throw();
+  });
+
+  it('should throw if the event handler is not a function', () => {
+    (() => {
+      loot.subscribe({});
+    }).should.throw();
+  });
+
+  it('should not throw if an event handler is passed', () => {
+    let queryId;
+    (() => {
+      queryId = loot.subscribe(() => {});
+    }).should.not.throw();
+
+    window.cefQueryCancel(queryId);
+  });
+});
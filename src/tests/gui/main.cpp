@@ -24,11 +24,19 @@
 
 #include <boost/locale.hpp>
 
+#include "tests/gui/state/background_plugin_loader_test.h"
+#include "tests/gui/state/form_id_index_test.h"
+#include "tests/gui/state/game_batch_test.h"
 #include "tests/gui/state/game_settings_test.h"
 #include "tests/gui/state/game_test.h"
+#include "tests/gui/state/load_order_moves_test.h"
 #include "tests/gui/state/loot_paths_test.h"
 #include "tests/gui/state/loot_settings_test.h"
 #include "tests/gui/state/loot_state_test.h"
+#include "tests/gui/state/memory_usage_test.h"
+#include "tests/gui/state/modlist_batch_test.h"
+#include "tests/gui/state/performance_stats_test.h"
+#include "tests/gui/state/query_arena_test.h"
 
 int main(int argc, char **argv) {
   // Set the locale to get encoding conversions working correctly.
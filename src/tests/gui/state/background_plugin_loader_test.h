@@ -0,0 +1,126 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_BACKGROUND_PLUGIN_LOADER_TEST
+#define LOOT_TESTS_GUI_STATE_BACKGROUND_PLUGIN_LOADER_TEST
+
+#include "gui/state/background_plugin_loader.h"
+
+#include <chrono>
+#include <thread>
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class BackgroundPluginLoaderTest : public loot::test::CommonGameTestFixture {
+protected:
+  void SetUp() {
+    CommonGameTestFixture::SetUp();
+
+    game_ = std::unique_ptr<Game>(new Game(
+        GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+        lootDataPath,
+        localPath));
+    game_->Init();
+    game_->LoadAllInstalledPlugins(true);
+  }
+
+  void TearDown() {
+    loader_.Cancel();
+
+    CommonGameTestFixture::TearDown();
+  }
+
+  void waitForLoader() {
+    using std::chrono::steady_clock;
+    auto timeout = steady_clock::now() + std::chrono::seconds(10);
+    while (loader_.IsRunning() && steady_clock::now() < timeout) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_FALSE(loader_.IsRunning());
+  }
+
+  std::unique_ptr<Game> game_;
+  BackgroundPluginLoader loader_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        BackgroundPluginLoaderTest,
+                        ::testing::Values(GameType::tes4,
+                                          GameType::tes5,
+                                          GameType::fo3,
+                                          GameType::fonv,
+                                          GameType::fo4,
+                                          GameType::tes5se));
+
+TEST_P(BackgroundPluginLoaderTest, isRunningShouldBeFalseByDefault) {
+  EXPECT_FALSE(loader_.IsRunning());
+}
+
+TEST_P(BackgroundPluginLoaderTest, startShouldFullyLoadTheGamesPlugins) {
+  auto pluginsCount = game_->GetPlugins().size();
+
+  loader_.Start(*game_, 1);
+  waitForLoader();
+
+  EXPECT_TRUE(game_->ArePluginsFullyLoaded());
+  EXPECT_EQ(pluginsCount, game_->GetPlugins().size());
+  EXPECT_EQ(blankEsm, game_->GetPlugin(blankEsm)->GetName());
+}
+
+TEST_P(BackgroundPluginLoaderTest,
+       startShouldNotLoadPluginsIfTheyAreAlreadyFullyLoaded) {
+  game_->LoadAllInstalledPlugins(false);
+  auto loadId = game_->GetPluginsLoadId();
+
+  loader_.Start(*game_, 1);
+
+  EXPECT_FALSE(loader_.IsRunning());
+  EXPECT_EQ(loadId, game_->GetPluginsLoadId());
+}
+
+TEST_P(BackgroundPluginLoaderTest,
+       reloadingPluginsDuringABackgroundLoadShouldDiscardItsResults) {
+  loader_.Start(*game_, 1);
+  game_->LoadAllInstalledPlugins(true);
+  waitForLoader();
+
+  EXPECT_FALSE(game_->ArePluginsFullyLoaded());
+}
+
+TEST_P(BackgroundPluginLoaderTest, cancelShouldStopTheLoaderThread) {
+  loader_.Start(*game_, 1);
+  loader_.Cancel();
+
+  EXPECT_FALSE(loader_.IsRunning());
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,295 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_FORM_ID_INDEX_TEST
+#define LOOT_TESTS_GUI_STATE_FORM_ID_INDEX_TEST
+
+#include "gui/state/form_id_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class FormIdIndexTest : public loot::test::CommonGameTestFixture {
+protected:
+  void update(const std::vector<std::string>& pluginNames) {
+    index_.Update(GetParam(), dataPath, pluginNames);
+  }
+
+  FormIdIndex index_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        FormIdIndexTest,
+                        ::testing::Values(GameType::tes4,
+                                          GameType::tes5,
+                                          GameType::fo3,
+                                          GameType::fonv,
+                                          GameType::fo4,
+                                          GameType::tes5se));
+
+TEST_P(FormIdIndexTest, indexShouldBeEmptyByDefault) {
+  EXPECT_TRUE(index_.IsEmpty());
+  EXPECT_TRUE(index_.GetOverlappingPlugins(blankEsm).empty());
+}
+
+TEST_P(FormIdIndexTest,
+       overlappingPluginsShouldIncludePluginsThatOverrideTheGivenPlugin) {
+  update({blankEsm, blankDifferentEsm, blankMasterDependentEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            index_.GetOverlappingPlugins(blankEsm));
+}
+
+TEST_P(FormIdIndexTest, overlapShouldBeFoundInBothDirections) {
+  update({blankEsm, blankMasterDependentEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankEsm}),
+            index_.GetOverlappingPlugins(blankMasterDependentEsm));
+}
+
+TEST_P(FormIdIndexTest, pluginsShouldOverlapIfOneOverridesTheOther) {
+  update({blankEsm, blankDifferentEsm, blankMasterDependentEsm});
+
+  EXPECT_TRUE(index_.DoPluginsOverlap(blankEsm, blankMasterDependentEsm));
+  EXPECT_TRUE(index_.DoPluginsOverlap(blankMasterDependentEsm, blankEsm));
+  EXPECT_FALSE(index_.DoPluginsOverlap(blankEsm, blankDifferentEsm));
+}
+
+TEST_P(FormIdIndexTest, checkingOverlapWithAnUnindexedPluginShouldThrow) {
+  update({blankEsm});
+
+  EXPECT_THROW(index_.DoPluginsOverlap(blankEsm, blankMasterDependentEsm),
+               std::invalid_argument);
+}
+
+TEST_P(FormIdIndexTest, overlappingPluginsShouldBeEmptyForAnUnindexedPlugin) {
+  update({blankEsm, blankMasterDependentEsm});
+
+  EXPECT_TRUE(index_.GetOverlappingPlugins(blankDifferentEsm).empty());
+}
+
+TEST_P(FormIdIndexTest, updatingShouldRemovePluginsThatAreNoLongerGiven) {
+  update({blankEsm, blankMasterDependentEsm});
+  update({blankEsm});
+
+  EXPECT_TRUE(index_.GetOverlappingPlugins(blankEsm).empty());
+  EXPECT_FALSE(index_.IsEmpty());
+}
+
+TEST_P(FormIdIndexTest, updatingShouldAddNewPluginsToTheExistingIndex) {
+  update({blankEsm});
+  update({blankEsm, blankMasterDependentEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            index_.GetOverlappingPlugins(blankEsm));
+}
+
+TEST_P(FormIdIndexTest, pluginsAddedAfterOthersAreRemovedShouldStillOverlap) {
+  update({blankEsm, blankDifferentEsm});
+  update({blankDifferentEsm});
+  update({blankDifferentEsm, blankMasterDependentEsm, blankEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            index_.GetOverlappingPlugins(blankEsm));
+  EXPECT_TRUE(index_.DoPluginsOverlap(blankEsm, blankMasterDependentEsm));
+  EXPECT_EQ(3, index_.GetConflictMatrix().plugins.size());
+}
+
+TEST_P(FormIdIndexTest, formIdCountShouldBeZeroForAnUnindexedPlugin) {
+  update({blankEsm});
+
+  EXPECT_NE(0, index_.GetFormIdCount(blankEsm));
+  EXPECT_EQ(0, index_.GetFormIdCount(blankDifferentEsm));
+}
+
+TEST_P(FormIdIndexTest, updatingShouldNotReadAnythingIfCancelled) {
+  std::atomic<bool> cancelled(true);
+  index_.Update(GetParam(),
+                dataPath,
+                {blankEsm, blankMasterDependentEsm},
+                &cancelled);
+
+  EXPECT_TRUE(index_.IsEmpty());
+}
+
+TEST_P(FormIdIndexTest, conflictMatrixShouldListEveryIndexedPlugin) {
+  update({blankEsm, blankDifferentEsm, blankMasterDependentEsm});
+
+  auto matrix = index_.GetConflictMatrix();
+
+  ASSERT_EQ(3, matrix.plugins.size());
+  ASSERT_EQ(3, matrix.conflicts.size());
+}
+
+TEST_P(FormIdIndexTest, conflictMatrixShouldRecordConflictsInBothDirections) {
+  update({blankEsm, blankDifferentEsm, blankMasterDependentEsm});
+
+  auto matrix = index_.GetConflictMatrix();
+
+  auto indexOf = [&](const std::string& name) {
+    return static_cast<uint32_t>(
+        std::find(matrix.plugins.begin(), matrix.plugins.end(), name) -
+        matrix.plugins.begin());
+  };
+  auto esm = indexOf(blankEsm);
+  auto dependent = indexOf(blankMasterDependentEsm);
+
+  ASSERT_EQ(1, matrix.conflicts[esm].size());
+  EXPECT_EQ(dependent, matrix.conflicts[esm][0].first);
+  EXPECT_LT(0, matrix.conflicts[esm][0].second);
+
+  ASSERT_EQ(1, matrix.conflicts[dependent].size());
+  EXPECT_EQ(esm, matrix.conflicts[dependent][0].first);
+  EXPECT_EQ(matrix.conflicts[esm][0].second,
+            matrix.conflicts[dependent][0].second);
+
+  EXPECT_TRUE(matrix.conflicts[indexOf(blankDifferentEsm)].empty());
+}
+
+TEST_P(FormIdIndexTest, conflictMatrixShouldReportProgress) {
+  update({blankEsm, blankMasterDependentEsm});
+
+  size_t lastDone = 0;
+  size_t lastTotal = 0;
+  index_.GetConflictMatrix([&](size_t done, size_t total) {
+    lastDone = done;
+    lastTotal = total;
+  });
+
+  EXPECT_LT(0, lastTotal);
+  EXPECT_GE(lastTotal, lastDone);
+}
+
+TEST_P(FormIdIndexTest, conflictMatrixShouldBeEmptyIfCancelled) {
+  update({blankEsm, blankMasterDependentEsm});
+
+  std::atomic<bool> cancelled(true);
+  auto matrix = index_.GetConflictMatrix(nullptr, &cancelled);
+
+  EXPECT_TRUE(matrix.plugins.empty());
+  EXPECT_TRUE(matrix.conflicts.empty());
+}
+
+TEST_P(FormIdIndexTest, updatingShouldStoreTheIndexIfGivenAPersistencePath) {
+  FormIdIndex index(lootDataPath / "formids.bin");
+  index.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+
+  EXPECT_TRUE(boost::filesystem::exists(lootDataPath / "formids.bin"));
+}
+
+TEST_P(FormIdIndexTest, aNewIndexShouldBeUpdatedFromTheStoredIndex) {
+  FormIdIndex index(lootDataPath / "formids.bin");
+  index.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+
+  FormIdIndex newIndex(lootDataPath / "formids.bin");
+  newIndex.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            newIndex.GetOverlappingPlugins(blankEsm));
+}
+
+TEST_P(FormIdIndexTest,
+       storedPluginsWithTheSameCrcShouldStillBeIndexedAfterBeingRedated) {
+  FormIdIndex index(lootDataPath / "formids.bin");
+  index.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+  index.SetCrcs({{blankEsm, blankEsmCrc}});
+
+  auto time = boost::filesystem::last_write_time(dataPath / blankEsm);
+  boost::filesystem::last_write_time(dataPath / blankEsm, time + 60);
+
+  FormIdIndex newIndex(lootDataPath / "formids.bin");
+  newIndex.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+  boost::filesystem::last_write_time(dataPath / blankEsm, time);
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            newIndex.GetOverlappingPlugins(blankEsm));
+}
+
+TEST_P(FormIdIndexTest, pluginsThatCouldNotBeReadShouldBeReadAgainLater) {
+  // Make the plugin unreadable without changing its size or timestamp.
+  auto path = dataPath / blankEsm;
+  auto time = boost::filesystem::last_write_time(path);
+  std::string content;
+  {
+    boost::filesystem::ifstream in(path, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>());
+  }
+  auto writePlugin = [&](const std::string& data) {
+    boost::filesystem::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+    out.close();
+    boost::filesystem::last_write_time(path, time);
+  };
+  writePlugin("XXXX" + content.substr(4));
+
+  FormIdIndex index(lootDataPath / "formids.bin");
+  index.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+  ASSERT_EQ(0, index.GetFormIdCount(blankEsm));
+
+  writePlugin(content);
+
+  FormIdIndex newIndex(lootDataPath / "formids.bin");
+  newIndex.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+  index.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            newIndex.GetOverlappingPlugins(blankEsm));
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            index.GetOverlappingPlugins(blankEsm));
+}
+
+TEST_P(FormIdIndexTest, aStoredIndexInAnUnrecognisedFormatShouldBeIgnored) {
+  boost::filesystem::ofstream out(lootDataPath / "formids.bin");
+  out << "not an index";
+  out.close();
+
+  FormIdIndex index(lootDataPath / "formids.bin");
+  index.Update(GetParam(), dataPath, {blankEsm, blankMasterDependentEsm});
+
+  EXPECT_EQ(std::vector<std::string>({blankMasterDependentEsm}),
+            index.GetOverlappingPlugins(blankEsm));
+}
+
+TEST_P(FormIdIndexTest, clearShouldEmptyTheIndex) {
+  update({blankEsm, blankMasterDependentEsm});
+  index_.Clear();
+
+  EXPECT_TRUE(index_.IsEmpty());
+  EXPECT_EQ(0, index_.EstimateMemoryUsage());
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_BATCH_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_BATCH_TEST
+
+#include "gui/state/game_batch.h"
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class GameBatchTest : public loot::test::CommonGameTestFixture {
+protected:
+  GameBatchTest() :
+      game_(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+            lootDataPath,
+            localPath) {}
+
+  Game game_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        GameBatchTest,
+                        ::testing::Values(GameType::tes4,
+                                          GameType::tes5,
+                                          GameType::fo3,
+                                          GameType::fonv,
+                                          GameType::fo4,
+                                          GameType::tes5se));
+
+TEST_P(GameBatchTest, runGameBatchShouldReturnNoResultsIfGivenNoGames) {
+  EXPECT_TRUE(runGameBatch({}, GameBatchOptions()).empty());
+}
+
+TEST_P(GameBatchTest, runGameBatchShouldSortWithoutApplyingByDefault) {
+  auto loadOrder = game_.GetLoadOrder();
+
+  auto results = runGameBatch({&game_}, GameBatchOptions());
+
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(game_.FolderName(), results[0].folderName);
+  EXPECT_TRUE(results[0].error.empty());
+  EXPECT_FALSE(results[0].isMasterlistUpdated);
+  EXPECT_TRUE(results[0].isSorted);
+  EXPECT_FALSE(results[0].isApplied);
+  EXPECT_EQ(loadOrder.size(), results[0].sortedLoadOrder.size());
+  EXPECT_EQ(loadOrder, game_.GetLoadOrder());
+}
+
+TEST_P(GameBatchTest, runGameBatchShouldApplyTheSortedLoadOrderIfAskedTo) {
+  GameBatchOptions options;
+  options.applySortedLoadOrder = true;
+
+  auto results = runGameBatch({&game_}, options);
+
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].isApplied);
+  EXPECT_EQ(results[0].sortedLoadOrder, game_.GetLoadOrder());
+}
+
+TEST_P(GameBatchTest, runGameBatchShouldReturnResultsInTheOrderOfTheGames) {
+  // Use a separate LOOT data folder so that the games don't share files.
+  Game otherGame(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                 lootDataPath / "other",
+                 localPath);
+  Game missingGame(GameSettings(GetParam()).SetGamePath(missingPath),
+                   lootDataPath,
+                   localPath);
+
+  auto results =
+      runGameBatch({&missingGame, &game_, &otherGame}, GameBatchOptions());
+
+  ASSERT_EQ(3, results.size());
+  EXPECT_FALSE(results[0].error.empty());
+  EXPECT_FALSE(results[0].isValid);
+  EXPECT_TRUE(results[1].error.empty());
+  EXPECT_TRUE(results[2].error.empty());
+  EXPECT_EQ(results[1].sortedLoadOrder, results[2].sortedLoadOrder);
+}
+
+TEST_P(GameBatchTest, runProfileBatchShouldSortEachProfileWithTheGamesPlugins) {
+  auto profilePath = lootDataPath / "profile";
+  ASSERT_NO_THROW(boost::filesystem::create_directories(profilePath));
+  for (const auto& filename : {"plugins.txt", "loadorder.txt"}) {
+    if (boost::filesystem::exists(localPath / filename))
+      boost::filesystem::copy_file(localPath / filename,
+                                   profilePath / filename);
+  }
+  Game profile = game_.CreateProfile(localPath);
+  Game otherProfile = game_.CreateProfile(profilePath);
+
+  auto results =
+      runProfileBatch(game_, {&profile, &otherProfile}, GameBatchOptions());
+
+  ASSERT_EQ(2, results.size());
+  EXPECT_TRUE(results[0].error.empty());
+  EXPECT_TRUE(results[1].error.empty());
+  EXPECT_EQ(localPath.string(), results[0].profilePath);
+  EXPECT_EQ(profilePath.string(), results[1].profilePath);
+  EXPECT_TRUE(results[0].isSorted);
+  EXPECT_EQ(results[0].sortedLoadOrder, results[1].sortedLoadOrder);
+  EXPECT_TRUE(game_.IsLoadedStateCurrent());
+}
+}
+}
+}
+
+#endif
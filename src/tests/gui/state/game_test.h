@@ -27,6 +27,8 @@ along with LOOT.  If not, see
 
 #include "gui/state/game.h"
 
+#include <future>
+
 #include "gui/state/game_detection_error.h"
 #include "tests/common_game_test_fixture.h"
 
@@ -102,6 +104,13 @@ TEST_P(GameTest, constructingFromGameSettingsShouldUseTheirValues) {
   EXPECT_EQ(lootDataPath / "folder" / "userlist.yaml", game.UserlistPath());
 }
 
+TEST_P(GameTest, constructingShouldNotDetectTheGamePathIfToldNotTo) {
+  auto settings = GameSettings(GetParam()).SetGamePath("missing");
+  Game game(settings, lootDataPath, localPath, false);
+
+  EXPECT_EQ("missing", game.GamePath());
+}
+
 #ifndef _WIN32
 // Testing on Windows will find real game installs in the Registry, so cannot
 // test autodetection fully unless on Linux.
@@ -110,9 +119,16 @@ TEST_P(GameTest, constructingShouldThrowOnLinuxIfGamePathIsNotGiven) {
                GameDetectionError);
 }
 
-TEST_P(GameTest, constructingShouldThrowOnLinuxIfLocalPathIsNotGiven) {
+TEST_P(GameTest, constructingShouldNotThrowOnLinuxIfLocalPathIsNotGiven) {
+  auto settings = GameSettings(GetParam()).SetGamePath(dataPath.parent_path());
+  EXPECT_NO_THROW(Game(settings, lootDataPath));
+}
+
+TEST_P(GameTest, initShouldThrowOnLinuxIfLocalPathIsNotGiven) {
   auto settings = GameSettings(GetParam()).SetGamePath(dataPath.parent_path());
-  EXPECT_THROW(Game(settings, lootDataPath), std::system_error);
+  Game game(settings, lootDataPath);
+
+  EXPECT_THROW(game.Init(), std::system_error);
 }
 #else
 TEST_P(GameTest, constructingShouldNotThrowOnWindowsIfLocalPathIsNotGiven) {
@@ -156,6 +172,19 @@ TEST_P(GameTest, isInstalledShouldBeTrueIfGamePathIsValid) {
       GameSettings(GetParam()).SetGamePath(dataPath.parent_path())));
 }
 
+TEST_P(GameTest, detectGamePathsShouldReturnAPathForEachGameInTheSameOrder) {
+  auto paths = Game::DetectGamePaths({
+      GameSettings(GetParam()),
+      GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+      GameSettings(GetParam()).SetGamePath(dataPath.parent_path() / "missing"),
+  });
+
+  ASSERT_EQ(3, paths.size());
+  EXPECT_TRUE(paths[0].empty());
+  EXPECT_EQ(dataPath.parent_path(), paths[1]);
+  EXPECT_TRUE(paths[2].empty());
+}
+
 TEST_P(GameTest, isInstalledShouldBeTrueForOnlyOneSiblingGameAtATime) {
   auto currentPath = boost::filesystem::current_path();
 
@@ -528,6 +557,173 @@ TEST_P(GameTest, pluginsShouldBeFullyLoadedAfterFullyLoadingThem) {
   EXPECT_TRUE(game.ArePluginsFullyLoaded());
 }
 
+TEST_P(GameTest, loadingPluginsShouldChangeThePluginsLoadId) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+
+  auto loadId = game.GetPluginsLoadId();
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+
+  EXPECT_NE(loadId, game.GetPluginsLoadId());
+}
+
+TEST_P(GameTest, adoptingFullLoadDataShouldUseItWithTheLoadedPluginHeaders) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  auto pluginsCount = game.GetPlugins().size();
+
+  auto handle = game.CreateDetachedGameHandle();
+  handle->LoadPlugins({blankEsm}, false);
+  auto plugin = handle->GetPlugin(blankEsm);
+
+  EXPECT_TRUE(game.AdoptFullLoadData(
+      {{boost::to_lower_copy(blankEsm), FullLoadData(*plugin)}},
+      game.GetPluginsLoadId()));
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_EQ(pluginsCount, game.GetPlugins().size());
+  EXPECT_EQ(blankEsmCrc, game.GetPlugin(blankEsm)->GetCRC());
+  EXPECT_EQ(0, game.GetPlugin(blankDifferentEsm)->GetCRC());
+}
+
+TEST_P(GameTest, adoptingFullLoadDataWithAStaleLoadIdShouldDiscardIt) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  auto loadId = game.GetPluginsLoadId();
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+
+  auto handle = game.CreateDetachedGameHandle();
+  handle->LoadPlugins({blankEsm}, false);
+  auto plugin = handle->GetPlugin(blankEsm);
+
+  EXPECT_FALSE(game.AdoptFullLoadData(
+      {{boost::to_lower_copy(blankEsm), FullLoadData(*plugin)}}, loadId));
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+  EXPECT_EQ(0, game.GetPlugin(blankEsm)->GetCRC());
+}
+
+TEST_P(GameTest, fullyLoadedPluginsShouldOnlyKeepTheirHeadersAndFullLoadData) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(false));
+
+  for (const auto& plugin : game.GetPlugins()) {
+    EXPECT_NE(nullptr, dynamic_cast<const CompactPlugin*>(plugin.get()));
+  }
+  EXPECT_EQ(blankEsmCrc, game.GetPlugin(blankEsm)->GetCRC());
+}
+
+TEST_P(GameTest, sharingLoadedPluginsShouldUseTheOtherGamesPlugins) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  Game profile = game.CreateProfile(localPath);
+
+  ASSERT_NO_THROW(profile.ShareLoadedPlugins(game));
+
+  EXPECT_FALSE(profile.ArePluginsFullyLoaded());
+  EXPECT_TRUE(profile.IsLoadedStateCurrent());
+  EXPECT_EQ(game.GetPlugins(), profile.GetPlugins());
+  EXPECT_EQ(game.GetPlugin(blankEsm), profile.GetPlugin(blankEsm));
+}
+
+TEST_P(GameTest, aProfileShouldHaveItsOwnLocalDataPathAndShareTheMetadataFiles) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  auto profilePath = localPath / "profile";
+
+  Game profile = game.CreateProfile(profilePath);
+
+  EXPECT_EQ(profilePath, profile.LocalDataPath());
+  EXPECT_EQ(game.DataPath(), profile.DataPath());
+  EXPECT_EQ(game.MasterlistPath(), profile.MasterlistPath());
+  EXPECT_EQ(game.UserlistPath(), profile.UserlistPath());
+  EXPECT_EQ(game.GetFormIdIndex(), profile.GetFormIdIndex());
+}
+
+TEST_P(GameTest, snapshotShouldBeEmptyByDefault) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+
+  auto snapshot = game.GetSnapshot();
+
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_TRUE(snapshot->GetLoadOrder().empty());
+  EXPECT_EQ(nullptr, snapshot->GetPluginFacts(blankEsm));
+}
+
+TEST_P(GameTest, loadingPluginsShouldPublishANewSnapshot) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+  game.Init();
+  auto oldSnapshot = game.GetSnapshot();
+
+  game.LoadAllInstalledPlugins(true);
+  auto snapshot = game.GetSnapshot();
+
+  EXPECT_GT(snapshot->GetVersion(), oldSnapshot->GetVersion());
+  EXPECT_EQ(game.GetLoadOrder(), snapshot->GetLoadOrder());
+  EXPECT_EQ(nullptr, oldSnapshot->GetPluginFacts(blankEsm));
+  ASSERT_NE(nullptr, snapshot->GetPluginFacts(blankEsm));
+  EXPECT_EQ(game.GetPlugin(blankEsm)->GetCRC(),
+            snapshot->GetPluginFacts(blankEsm)->crc);
+}
+
+TEST_P(GameTest, snapshotPluginLookupsShouldBeCaseInsensitive) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto snapshot = game.GetSnapshot();
+
+  EXPECT_EQ(snapshot->GetPluginFacts(blankEsm),
+            snapshot->GetPluginFacts(boost::to_upper_copy(blankEsm)));
+}
+
+TEST_P(GameTest,
+       snapshotActiveLoadOrderIndicesShouldMatchGetActiveLoadOrderIndex) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   "",
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto snapshot = game.GetSnapshot();
+  auto loadOrder = game.GetLoadOrder();
+
+  for (const auto& plugin : game.GetPlugins()) {
+    EXPECT_EQ(game.GetActiveLoadOrderIndex(plugin, loadOrder),
+              snapshot->GetActiveLoadOrderIndex(plugin->GetName()));
+    EXPECT_EQ(game.IsPluginActive(plugin->GetName()),
+              snapshot->IsPluginActive(plugin->GetName()));
+  }
+}
+
+TEST_P(GameTest, appendingAMessageShouldPublishASnapshotWithTheMessage) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  auto oldSnapshot = game.GetSnapshot();
+
+  game.AppendMessage(Message(MessageType::say, "1"));
+
+  EXPECT_EQ(oldSnapshot->GetMessages().size() + 1,
+            game.GetSnapshot()->GetMessages().size());
+  EXPECT_EQ(game.GetMessages(), game.GetSnapshot()->GetMessages());
+}
+
 TEST_P(
     GameTest,
     GetActiveLoadOrderIndexShouldReturnNegativeOneForAPluginThatIsNotActive) {
@@ -831,6 +1027,425 @@ TEST_P(GameTest, clearingMessagesShouldRemoveAllAppendedMessages) {
 
   EXPECT_EQ(previousSize - messages.size(), game.GetMessages().size());
 }
+
+TEST_P(GameTest, differentGamesShouldHaveDifferentMetadataGenerations) {
+  Game game1 = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                    lootDataPath,
+                    localPath);
+  Game game2 = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                    lootDataPath,
+                    localPath);
+
+  EXPECT_NE(game1.GetMetadataGeneration(), game2.GetMetadataGeneration());
+}
+
+TEST_P(GameTest, copyingAGameShouldShareItsMetadataGeneration) {
+  Game game1 = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                    lootDataPath,
+                    localPath);
+  Game game2 = game1;
+
+  game1.AddUserMetadata(PluginMetadata(blankEsm));
+
+  EXPECT_EQ(game1.GetMetadataGeneration(), game2.GetMetadataGeneration());
+}
+
+TEST_P(GameTest, changingUserMetadataShouldChangeTheMetadataGeneration) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  auto generation = game.GetMetadataGeneration();
+  game.AddUserMetadata(PluginMetadata(blankEsm));
+  EXPECT_NE(generation, game.GetMetadataGeneration());
+
+  generation = game.GetMetadataGeneration();
+  game.ClearUserMetadata(blankEsm);
+  EXPECT_NE(generation, game.GetMetadataGeneration());
+
+  generation = game.GetMetadataGeneration();
+  game.ClearAllUserMetadata();
+  EXPECT_NE(generation, game.GetMetadataGeneration());
+}
+
+TEST_P(GameTest, loadingMetadataShouldChangeTheMetadataGeneration) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  auto generation = game.GetMetadataGeneration();
+  game.LoadMetadata();
+
+  EXPECT_NE(generation, game.GetMetadataGeneration());
+}
+
+TEST_P(GameTest, installFingerprintShouldChangeWhenAPluginIsAdded) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  auto fingerprint = game.GetInstallFingerprint();
+  boost::filesystem::copy_file(dataPath / blankEsp, dataPath / "New.esp");
+  auto newFingerprint = game.GetInstallFingerprint();
+  boost::filesystem::remove(dataPath / "New.esp");
+
+  EXPECT_NE(fingerprint, newFingerprint);
+  EXPECT_EQ(fingerprint, game.GetInstallFingerprint());
+}
+
+TEST_P(GameTest, installFingerprintShouldChangeWhenANonPluginFileIsAdded) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  auto fingerprint = game.GetInstallFingerprint();
+  boost::filesystem::ofstream out(dataPath / "Blank.bsa");
+  out << "archive";
+  out.close();
+  auto newFingerprint = game.GetInstallFingerprint();
+  boost::filesystem::remove(dataPath / "Blank.bsa");
+
+  EXPECT_NE(fingerprint, newFingerprint);
+  EXPECT_EQ(fingerprint, game.GetInstallFingerprint());
+}
+
+TEST_P(GameTest, loadedInstallFingerprintShouldBeStoredWhenPluginsAreLoaded) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  EXPECT_EQ(0, game.GetLoadedInstallFingerprint());
+
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_EQ(game.GetInstallFingerprint(), game.GetLoadedInstallFingerprint());
+}
+
+TEST_P(GameTest, loadedStateShouldNotBeCurrentIfPluginsHaveNotBeenLoaded) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  EXPECT_FALSE(game.IsLoadedStateCurrent());
+}
+
+TEST_P(GameTest, loadedStateShouldBeCurrentAfterLoadingPlugins) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_TRUE(game.IsLoadedStateCurrent());
+}
+
+TEST_P(GameTest, loadedStateShouldNotBeCurrentIfAPluginIsAddedAfterLoading) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  game.LoadAllInstalledPlugins(true);
+  boost::filesystem::copy_file(dataPath / blankEsp, dataPath / "New.esp");
+  bool isCurrent = game.IsLoadedStateCurrent();
+  boost::filesystem::remove(dataPath / "New.esp");
+
+  EXPECT_FALSE(isCurrent);
+}
+
+TEST_P(GameTest, unloadShouldClearPluginsAndChangeTheMetadataGeneration) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.LoadAllInstalledPlugins(false);
+  game.CacheDerivedData("key", "data");
+
+  auto generation = game.GetMetadataGeneration();
+  auto memoryUsage = game.EstimateMemoryUsage();
+  game.Unload();
+
+  EXPECT_TRUE(game.GetPlugins().empty());
+  EXPECT_EQ(nullptr, game.GetSnapshot()->GetPluginFacts(blankEsm));
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+  EXPECT_FALSE(game.IsLoadedStateCurrent());
+  EXPECT_NE(generation, game.GetMetadataGeneration());
+  EXPECT_TRUE(game.GetCachedDerivedData("key").empty());
+  EXPECT_GT(memoryUsage, game.EstimateMemoryUsage());
+}
+
+TEST_P(GameTest, unloadShouldNotRecreateTheGameHandle) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  boost::filesystem::ofstream out(game.MasterlistPath());
+  out << "plugins:\n  - name: " << blankEsp << "\n";
+  out.close();
+  game.LoadMetadata();
+  ASSERT_NE(0, game.GetMemoryUsage().metadata);
+
+  game.Unload();
+
+  // Metadata is only counted while the game has a handle.
+  EXPECT_EQ(0, game.GetMemoryUsage().metadata);
+  EXPECT_EQ(1, game.GetSnapshot()->GetMessages().size());
+}
+
+// These tests fetch the masterlist from the testing-metadata repository, so
+// need network access.
+TEST_P(GameTest,
+       updateMasterlistFileShouldNotChangeTheGameUntilTheUpdateIsRecorded) {
+  Game game = Game(GameSettings(GetParam())
+                       .SetGamePath(dataPath.parent_path())
+                       .SetRepoURL("https://github.com/loot/testing-metadata.git")
+                       .SetRepoBranch("master"),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  auto version = game.GetSnapshot()->GetVersion();
+  auto generation = game.GetMetadataGeneration();
+  auto messageCount = game.GetSnapshot()->GetMessages().size();
+
+  auto update = game.UpdateMasterlistFile();
+
+  ASSERT_TRUE(update.isUpdated);
+  EXPECT_TRUE(update.isLatestValid);
+  EXPECT_TRUE(boost::filesystem::exists(game.MasterlistPath()));
+  EXPECT_EQ(version, game.GetSnapshot()->GetVersion());
+  EXPECT_EQ(generation, game.GetMetadataGeneration());
+
+  game.RecordMasterlistUpdate(update);
+
+  EXPECT_NE(version, game.GetSnapshot()->GetVersion());
+  EXPECT_NE(generation, game.GetMetadataGeneration());
+  EXPECT_EQ(messageCount, game.GetSnapshot()->GetMessages().size());
+}
+
+// Run under ThreadSanitizer to check that the update doesn't share anything
+// with the plugin load.
+TEST_P(GameTest, updateMasterlistFileShouldBeSafeToRunWhilePluginsLoad) {
+  Game game = Game(GameSettings(GetParam())
+                       .SetGamePath(dataPath.parent_path())
+                       .SetRepoURL("https://github.com/loot/testing-metadata.git")
+                       .SetRepoBranch("master"),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+
+  auto masterlistUpdate = std::async(
+      std::launch::async, [&game]() { return game.UpdateMasterlistFile(); });
+  game.LoadAllInstalledPlugins(true);
+  auto update = masterlistUpdate.get();
+  game.RecordMasterlistUpdate(update);
+  game.LoadMetadata();
+
+  EXPECT_TRUE(update.isUpdated);
+  EXPECT_EQ(11, game.GetPlugins().size());
+}
+
+TEST_P(GameTest, cachedDerivedDataShouldOnlyBeReturnedForTheKeyItWasStoredWith) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  EXPECT_TRUE(game.GetCachedDerivedData("").empty());
+
+  game.CacheDerivedData("key", "data");
+
+  EXPECT_EQ("data", game.GetCachedDerivedData("key"));
+  EXPECT_TRUE(game.GetCachedDerivedData("other").empty());
+  EXPECT_TRUE(game.GetCachedDerivedData("").empty());
+}
+
+TEST_P(GameTest, aGameWithNothingLoadedShouldUseNoMemoryForPluginsOrMetadata) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  auto usage = game.GetMemoryUsage();
+
+  EXPECT_EQ(0, usage.plugins);
+  EXPECT_EQ(0, usage.metadata);
+  EXPECT_EQ(0, usage.formIdIndex);
+  EXPECT_EQ(usage.Total(), game.EstimateMemoryUsage());
+}
+
+TEST_P(GameTest, memoryUsageShouldIncludeLoadedPluginsAndCachedDerivedData) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+  game.CacheDerivedData("key", std::string(1000, 'a'));
+
+  auto usage = game.GetMemoryUsage();
+
+  EXPECT_LT(0, usage.plugins);
+  EXPECT_LE(1000, usage.derivedData);
+  EXPECT_EQ(usage.Total(), game.EstimateMemoryUsage());
+}
+
+TEST_P(GameTest, loadOrderShouldNotBeSortedIfPluginsHaveNeverBeenSorted) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+
+  EXPECT_FALSE(game.IsSortResultStored());
+  EXPECT_FALSE(game.IsLoadOrderSorted());
+}
+
+TEST_P(GameTest, sortingShouldStoreTheResultForTheCurrentInstall) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+
+  auto sorted = game.SortPlugins();
+  ASSERT_FALSE(sorted.empty());
+
+  EXPECT_TRUE(game.IsSortResultStored());
+  EXPECT_EQ(sorted, game.SortPlugins());
+}
+
+TEST_P(GameTest, loadOrderShouldBeSortedAfterApplyingTheSortResult) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+
+  game.SetLoadOrder(game.SortPlugins());
+
+  EXPECT_TRUE(game.IsSortResultStored());
+  EXPECT_TRUE(game.IsLoadOrderSorted());
+}
+
+TEST_P(GameTest, theSortResultShouldBeKeptBetweenSessions) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.SetLoadOrder(game.SortPlugins());
+
+  Game newGame =
+      Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+           lootDataPath,
+           localPath);
+  newGame.Init();
+
+  EXPECT_TRUE(newGame.IsLoadOrderSorted());
+}
+
+TEST_P(GameTest, theSortResultShouldNotBeReusedIfTheUserlistChanges) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.SortPlugins();
+
+  boost::filesystem::ofstream out(game.UserlistPath());
+  out << "plugins:\n  - name: " << blankEsp << "\n    after: [" << blankEsm
+      << "]\n";
+  out.close();
+
+  EXPECT_FALSE(game.IsSortResultStored());
+}
+
+TEST_P(GameTest, checkLoadOrderShouldFindNothingIfNoPluginsAreLoaded) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+
+  EXPECT_TRUE(game.CheckLoadOrder().empty());
+}
+
+TEST_P(GameTest, checkLoadOrderShouldFindNothingIfAllConstraintsAreMet) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  EXPECT_TRUE(game.CheckLoadOrder().empty());
+}
+
+TEST_P(GameTest, checkLoadOrderShouldFindPluginsThatLoadBeforeTheirMasters) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto loadOrder = game.GetLoadOrder();
+  auto esp = std::find(loadOrder.begin(), loadOrder.end(), blankEsp);
+  auto dependent =
+      std::find(loadOrder.begin(), loadOrder.end(), blankPluginDependentEsp);
+  ASSERT_NE(loadOrder.end(), esp);
+  ASSERT_NE(loadOrder.end(), dependent);
+  std::iter_swap(esp, dependent);
+  game.SetLoadOrder(loadOrder);
+
+  auto violations = game.CheckLoadOrder();
+
+  ASSERT_EQ(1, violations.size());
+  EXPECT_EQ(blankPluginDependentEsp, violations[0].plugin);
+  EXPECT_EQ(blankEsp, violations[0].otherPlugin);
+  EXPECT_EQ(LoadOrderViolation::Reason::master, violations[0].reason);
+}
+
+TEST_P(GameTest, checkLoadOrderShouldCheckAgainAfterTheLoadOrderChanges) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+  ASSERT_TRUE(game.CheckLoadOrder().empty());
+
+  auto loadOrder = game.GetLoadOrder();
+  auto esp = std::find(loadOrder.begin(), loadOrder.end(), blankEsp);
+  auto dependent =
+      std::find(loadOrder.begin(), loadOrder.end(), blankPluginDependentEsp);
+  ASSERT_NE(loadOrder.end(), esp);
+  ASSERT_NE(loadOrder.end(), dependent);
+  std::iter_swap(esp, dependent);
+  game.SetLoadOrder(loadOrder);
+
+  EXPECT_EQ(1, game.CheckLoadOrder().size());
+}
+
+TEST_P(GameTest, checkLoadOrderShouldFindLoadAfterAndRequirementViolations) {
+  Game game = Game(GameSettings(GetParam()).SetGamePath(dataPath.parent_path()),
+                   lootDataPath,
+                   localPath);
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetLoadAfterFiles({File(blankEsp)});
+  game.AddUserMetadata(metadata);
+  metadata = PluginMetadata(blankDifferentEsm);
+  metadata.SetRequirements({File(blankDifferentEsp)});
+  game.AddUserMetadata(metadata);
+
+  auto violations = game.CheckLoadOrder();
+
+  ASSERT_EQ(2, violations.size());
+  EXPECT_EQ(blankEsm, violations[0].plugin);
+  EXPECT_EQ(blankEsp, violations[0].otherPlugin);
+  EXPECT_EQ(LoadOrderViolation::Reason::loadAfter, violations[0].reason);
+  EXPECT_EQ(blankDifferentEsm, violations[1].plugin);
+  EXPECT_EQ(blankDifferentEsp, violations[1].otherPlugin);
+  EXPECT_EQ(LoadOrderViolation::Reason::requirement, violations[1].reason);
+}
+
+TEST_P(GameTest, aLoadOrderViolationShouldBeConvertedToAWarningMessage) {
+  auto message = Game::ToMessage(LoadOrderViolation{
+      blankEsp, blankEsm, LoadOrderViolation::Reason::loadAfter});
+
+  EXPECT_EQ(MessageType::warn, message.GetType());
+  EXPECT_EQ("\"" + blankEsp + "\" loads before \"" + blankEsm +
+                "\", but should load after it.",
+            message.GetContent(MessageContent::defaultLanguage).GetText());
+}
 }
 }
 }
@@ -0,0 +1,93 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_LOAD_ORDER_MOVES_TEST
+#define LOOT_TESTS_GUI_STATE_LOAD_ORDER_MOVES_TEST
+
+#include "gui/state/load_order_moves.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(getLoadOrderMoves, shouldReturnNoMovesIfTheLoadOrdersAreEqual) {
+  std::vector<std::string> loadOrder({"A.esm", "B.esp", "C.esp"});
+
+  EXPECT_TRUE(getLoadOrderMoves(loadOrder, loadOrder).empty());
+}
+
+TEST(getLoadOrderMoves, shouldReturnOneMoveIfOnePluginHasMoved) {
+  auto moves = getLoadOrderMoves({"A.esm", "B.esp", "C.esp", "D.esp"},
+                                 {"A.esm", "D.esp", "B.esp", "C.esp"});
+
+  ASSERT_EQ(1, moves.size());
+  EXPECT_EQ("D.esp", moves[0].name);
+  EXPECT_EQ(3, moves[0].from);
+  EXPECT_EQ(1, moves[0].to);
+}
+
+TEST(getLoadOrderMoves, shouldReturnTheFewestMovesForAReversal) {
+  auto moves = getLoadOrderMoves({"A.esm", "B.esp", "C.esp", "D.esp"},
+                                 {"D.esp", "C.esp", "B.esp", "A.esm"});
+
+  EXPECT_EQ(3, moves.size());
+}
+
+TEST(getLoadOrderMoves, shouldThrowIfTheLoadOrdersContainDifferentPlugins) {
+  EXPECT_THROW(getLoadOrderMoves({"A.esm", "B.esp"}, {"A.esm", "C.esp"}),
+               std::invalid_argument);
+  EXPECT_THROW(getLoadOrderMoves({"A.esm", "B.esp"}, {"A.esm"}),
+               std::invalid_argument);
+  EXPECT_THROW(getLoadOrderMoves({"A.esm", "B.esp"}, {"A.esm", "A.esm"}),
+               std::invalid_argument);
+}
+
+TEST(applyLoadOrderMoves, shouldReturnTheLoadOrderTheMovesWereCalculatedFor) {
+  std::vector<std::string> loadOrder(
+      {"A.esm", "B.esp", "C.esp", "D.esp", "E.esp"});
+  std::vector<std::string> sortedLoadOrder(
+      {"B.esp", "A.esm", "E.esp", "C.esp", "D.esp"});
+
+  auto moves = getLoadOrderMoves(loadOrder, sortedLoadOrder);
+
+  EXPECT_EQ(sortedLoadOrder, applyLoadOrderMoves(loadOrder, moves));
+}
+
+TEST(applyLoadOrderMoves, shouldThrowIfAMoveDoesNotFitTheLoadOrder) {
+  std::vector<std::string> loadOrder({"A.esm", "B.esp"});
+
+  EXPECT_THROW(applyLoadOrderMoves(loadOrder, {{"B.esp", 0, 1}}),
+               std::invalid_argument);
+  EXPECT_THROW(applyLoadOrderMoves(loadOrder, {{"B.esp", 1, 2}}),
+               std::invalid_argument);
+  EXPECT_THROW(
+      applyLoadOrderMoves(loadOrder, {{"A.esm", 0, 1}, {"B.esp", 1, 1}}),
+      std::invalid_argument);
+}
+}
+}
+}
+
+#endif
@@ -61,6 +61,8 @@ TEST_F(LootSettingsTest, defaultConstructorShouldSetDefaultValues) {
 
   EXPECT_FALSE(settings_.isDebugLoggingEnabled());
   EXPECT_TRUE(settings_.updateMasterlist());
+  EXPECT_EQ(0, settings_.getBackgroundLoadThreads());
+  EXPECT_EQ(1024, settings_.getWarmGamesMemoryLimit());
   EXPECT_FALSE(settings_.isWindowPositionStored());
   EXPECT_EQ("auto", settings_.getGame());
   EXPECT_EQ("auto", settings_.getLastGame());
@@ -128,6 +130,8 @@ TEST_F(LootSettingsTest, loadingShouldReadFromATomlFile) {
   boost::filesystem::ofstream out(settingsFile_);
   out << "enableDebugLogging = true" << endl
       << "updateMasterlist = true" << endl
+      << "backgroundLoadThreads = 3" << endl
+      << "warmGamesMemoryLimit = 256" << endl
       << "game = \"Oblivion\"" << endl
       << "lastGame = \"Skyrim\"" << endl
       << "language = \"fr\"" << endl
@@ -154,6 +158,8 @@ TEST_F(LootSettingsTest, loadingShouldReadFromATomlFile) {
 
   EXPECT_TRUE(settings_.isDebugLoggingEnabled());
   EXPECT_TRUE(settings_.updateMasterlist());
+  EXPECT_EQ(3, settings_.getBackgroundLoadThreads());
+  EXPECT_EQ(256, settings_.getWarmGamesMemoryLimit());
   EXPECT_EQ("Oblivion", settings_.getGame());
   EXPECT_EQ("Skyrim", settings_.getLastGame());
   EXPECT_EQ("0.7.1", settings_.getLastVersion());
@@ -319,6 +325,8 @@ TEST_F(LootSettingsTest, saveShouldWriteSettingsToPassedTomlFile) {
 
   settings_.enableDebugLogging(true);
   settings_.updateMasterlist(true);
+  settings_.setBackgroundLoadThreads(3);
+  settings_.setWarmGamesMemoryLimit(256);
   settings_.setDefaultGame(game);
   settings_.storeLastGame(lastGame);
   settings_.setLanguage(language);
@@ -336,6 +344,8 @@ TEST_F(LootSettingsTest, saveShouldWriteSettingsToPassedTomlFile) {
 
   EXPECT_TRUE(settings.isDebugLoggingEnabled());
   EXPECT_TRUE(settings.updateMasterlist());
+  EXPECT_EQ(3, settings.getBackgroundLoadThreads());
+  EXPECT_EQ(256, settings.getWarmGamesMemoryLimit());
   EXPECT_EQ(game, settings.getGame());
   EXPECT_EQ(lastGame, settings.getLastGame());
   EXPECT_EQ(language, settings.getLanguage());
@@ -0,0 +1,86 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_MEMORY_USAGE_TEST
+#define LOOT_TESTS_GUI_STATE_MEMORY_USAGE_TEST
+
+#include "gui/state/memory_usage.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(CountingAllocator, shouldCountAllocationsUntilTheyAreFreed) {
+  auto before = MemoryCounters::Get(MemorySubsystem::queryResponses);
+  {
+    std::vector<uint32_t,
+                CountingAllocator<uint32_t, MemorySubsystem::queryResponses>>
+        vector;
+    vector.reserve(100);
+
+    auto during = MemoryCounters::Get(MemorySubsystem::queryResponses);
+    EXPECT_EQ(before.bytes + 100 * sizeof(uint32_t), during.bytes);
+    EXPECT_EQ(before.allocations + 1, during.allocations);
+  }
+  auto after = MemoryCounters::Get(MemorySubsystem::queryResponses);
+
+  EXPECT_EQ(before.bytes, after.bytes);
+  EXPECT_EQ(before.allocations, after.allocations);
+}
+
+TEST(CountedMemoryScope, shouldCountTheGivenBytesWhileInScope) {
+  auto before = MemoryCounters::Get(MemorySubsystem::derivedData);
+  {
+    CountedMemoryScope scope(MemorySubsystem::derivedData, 10);
+
+    EXPECT_EQ(before.bytes + 10,
+              MemoryCounters::Get(MemorySubsystem::derivedData).bytes);
+  }
+
+  EXPECT_EQ(before.bytes,
+            MemoryCounters::Get(MemorySubsystem::derivedData).bytes);
+}
+
+TEST(MemoryCounters, shouldNameEverySubsystem) {
+  for (const auto subsystem : MemoryCounters::GetSubsystems()) {
+    EXPECT_NE("unknown", MemoryCounters::GetName(subsystem));
+  }
+}
+
+TEST(GameMemoryUsage, totalShouldAddUpEveryPart) {
+  GameMemoryUsage usage;
+  usage.plugins = 1;
+  usage.metadata = 2;
+  usage.formIdIndex = 3;
+  usage.derivedData = 4;
+  usage.state = 5;
+
+  EXPECT_EQ(15, usage.Total());
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_MODLIST_BATCH_TEST
+#define LOOT_TESTS_GUI_STATE_MODLIST_BATCH_TEST
+
+#include "gui/state/modlist_batch.h"
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+class ModlistBatchTest : public loot::test::CommonGameTestFixture {
+protected:
+  ModlistBatchTest() : workPath(lootDataPath.parent_path() / "work") {
+    options_.workPath = workPath;
+    options_.lootDataPath = lootDataPath;
+  }
+
+  ModlistManifest createManifest(const std::string& name,
+                                 const std::vector<std::string>& plugins) {
+    ModlistManifest manifest;
+    manifest.name = name;
+    manifest.gameSettings = GameSettings(GetParam());
+    for (const auto& plugin : plugins) {
+      manifest.plugins.push_back({dataPath / plugin, true});
+    }
+
+    return manifest;
+  }
+
+  const boost::filesystem::path workPath;
+  ModlistBatchOptions options_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        ModlistBatchTest,
+                        ::testing::Values(GameType::tes4,
+                                          GameType::tes5,
+                                          GameType::fo3,
+                                          GameType::fonv,
+                                          GameType::fo4,
+                                          GameType::tes5se));
+
+TEST_P(ModlistBatchTest,
+       runModlistBatchShouldReturnNoReportsIfGivenNoManifests) {
+  auto result = runModlistBatch({}, options_);
+
+  EXPECT_TRUE(result.reports.empty());
+  EXPECT_EQ(0, result.pluginFileCount);
+  EXPECT_EQ(0, result.uniquePluginCount);
+}
+
+TEST_P(ModlistBatchTest,
+       runModlistBatchShouldCountPluginsSharedByModlistsOnce) {
+  auto result = runModlistBatch(
+      {
+          createManifest("first", {masterFile, blankEsm}),
+          createManifest("second", {masterFile, blankEsm, blankEsp}),
+      },
+      options_);
+
+  ASSERT_EQ(2, result.reports.size());
+  EXPECT_EQ(5, result.pluginFileCount);
+  EXPECT_EQ(3, result.uniquePluginCount);
+}
+
+TEST_P(ModlistBatchTest, runModlistBatchShouldReportMissingMasters) {
+  auto result = runModlistBatch(
+      {
+          createManifest("valid",
+                         {masterFile, blankEsm, blankMasterDependentEsm}),
+          createManifest("invalid", {masterFile, blankMasterDependentEsm}),
+      },
+      options_);
+
+  ASSERT_EQ(2, result.reports.size());
+  EXPECT_EQ("valid", result.reports[0].name);
+  EXPECT_TRUE(result.reports[0].error.empty());
+  EXPECT_TRUE(result.reports[0].missingMasters.empty());
+  EXPECT_TRUE(result.reports[0].isValid);
+
+  EXPECT_EQ("invalid", result.reports[1].name);
+  ASSERT_EQ(1, result.reports[1].missingMasters.size());
+  EXPECT_EQ(blankMasterDependentEsm,
+            result.reports[1].missingMasters[0].plugin);
+  EXPECT_EQ(blankEsm, result.reports[1].missingMasters[0].master);
+  EXPECT_FALSE(result.reports[1].isValid);
+}
+
+TEST_P(ModlistBatchTest, runModlistBatchShouldRemoveTheStagedInstalls) {
+  runModlistBatch({createManifest("modlist", {masterFile, blankEsm})},
+                  options_);
+
+  EXPECT_FALSE(boost::filesystem::exists(workPath / "plugins"));
+  EXPECT_FALSE(boost::filesystem::exists(workPath / "modlists" / "0"));
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_PERFORMANCE_STATS_TEST
+#define LOOT_TESTS_GUI_STATE_PERFORMANCE_STATS_TEST
+
+#include "gui/state/performance_stats.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(PhaseTimer, shouldNotRecordAnythingIfThereAreNoCurrentTimings) {
+  ASSERT_EQ(nullptr, PhaseTimings::Current());
+
+  PhaseTimer timer("phase");
+}
+
+TEST(PhaseTimer, shouldAddItsPhaseToTheCurrentTimings) {
+  PhaseTimings timings;
+  {
+    PhaseTimings::Scope scope(timings);
+    PhaseTimer timer("phase");
+  }
+
+  ASSERT_EQ(1, timings.GetPhases().size());
+  EXPECT_EQ("phase", timings.GetPhases()[0].name);
+  EXPECT_EQ(1, timings.GetPhases()[0].count);
+  EXPECT_EQ(nullptr, PhaseTimings::Current());
+}
+
+TEST(PhaseTimings, shouldAddTogetherPhasesWithTheSameName) {
+  PhaseTimings timings;
+  timings.Add("first", std::chrono::milliseconds(1));
+  timings.Add("second", std::chrono::milliseconds(2));
+  timings.Add("first", std::chrono::milliseconds(3));
+
+  ASSERT_EQ(2, timings.GetPhases().size());
+  EXPECT_EQ("first", timings.GetPhases()[0].name);
+  EXPECT_EQ(std::chrono::milliseconds(4), timings.GetPhases()[0].duration);
+  EXPECT_EQ(2, timings.GetPhases()[0].count);
+  EXPECT_EQ("second", timings.GetPhases()[1].name);
+}
+
+TEST(PhaseTimingsScope, shouldRestoreThePreviousTimingsWhenDestroyed) {
+  PhaseTimings outer;
+  PhaseTimings inner;
+  PhaseTimings::Scope outerScope(outer);
+  {
+    PhaseTimings::Scope innerScope(inner);
+    EXPECT_EQ(&inner, PhaseTimings::Current());
+  }
+
+  EXPECT_EQ(&outer, PhaseTimings::Current());
+}
+
+TEST(PerformanceStats, shouldKeepOnlyTheGivenNumberOfRecentExecutions) {
+  PerformanceStats stats(2);
+  PhaseTimings timings;
+  timings.Add("phase", std::chrono::milliseconds(1));
+
+  stats.Record("first", std::chrono::milliseconds(1), 10, timings);
+  stats.Record("second", std::chrono::milliseconds(2), 20, timings);
+  stats.Record("third", std::chrono::milliseconds(3), 30, timings);
+
+  auto executions = stats.GetRecentExecutions();
+  ASSERT_EQ(2, executions.size());
+  EXPECT_EQ("third", executions[0].name);
+  EXPECT_EQ(30, executions[0].responseSize);
+  EXPECT_EQ(1, executions[0].phases.size());
+  EXPECT_EQ("second", executions[1].name);
+}
+
+TEST(PerformanceStats, shouldTotalExecutionsWithTheSameName) {
+  PerformanceStats stats;
+  PhaseTimings timings;
+
+  stats.Record("sort", std::chrono::milliseconds(1), 0, timings);
+  stats.Record("apply", std::chrono::milliseconds(2), 0, timings);
+  stats.Record("sort", std::chrono::milliseconds(3), 0, timings);
+
+  auto totals = stats.GetTotals();
+  ASSERT_EQ(2, totals.size());
+  EXPECT_EQ("apply", totals[0].name);
+  EXPECT_EQ("sort", totals[1].name);
+  EXPECT_EQ(2, totals[1].count);
+  EXPECT_EQ(std::chrono::milliseconds(4), totals[1].duration);
+  EXPECT_EQ(std::chrono::milliseconds(3), totals[1].maxDuration);
+}
+}
+}
+}
+
+#endif
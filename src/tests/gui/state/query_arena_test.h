@@ -0,0 +1,139 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2017    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_QUERY_ARENA_TEST
+#define LOOT_TESTS_GUI_STATE_QUERY_ARENA_TEST
+
+#include "gui/state/query_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gui/state/memory_usage.h"
+
+namespace loot {
+namespace gui {
+namespace test {
+TEST(QueryArena, shouldNotReserveAnythingUntilSomethingIsAllocated) {
+  QueryArena arena;
+
+  EXPECT_EQ(0, arena.GetBytesReserved());
+}
+
+TEST(QueryArena, allocationsShouldBeAlignedAsRequested) {
+  QueryArena arena(64);
+
+  arena.Allocate(1, 1);
+  auto pointer = arena.Allocate(8, 8);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pointer) % 8);
+
+  arena.Allocate(1, 1);
+  pointer = arena.Allocate(32, 32);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pointer) % 32);
+}
+
+TEST(QueryArena, allocationsLargerThanABlockShouldStillSucceed) {
+  QueryArena arena(64);
+
+  auto pointer = static_cast<char*>(arena.Allocate(1000, 1));
+  std::fill(pointer, pointer + 1000, 'a');
+
+  EXPECT_LE(1000, arena.GetBytesReserved());
+}
+
+TEST(QueryArena, releasingShouldFreeAllBlocks) {
+  auto before = MemoryCounters::Get(MemorySubsystem::queryArenas);
+  QueryArena arena(64);
+  arena.Allocate(100, 1);
+  arena.Allocate(100, 1);
+
+  auto during = MemoryCounters::Get(MemorySubsystem::queryArenas);
+  EXPECT_EQ(before.bytes + arena.GetBytesReserved(), during.bytes);
+  EXPECT_EQ(before.allocations + 2, during.allocations);
+
+  arena.Release();
+  auto after = MemoryCounters::Get(MemorySubsystem::queryArenas);
+
+  EXPECT_EQ(0, arena.GetBytesReserved());
+  EXPECT_EQ(before.bytes, after.bytes);
+  EXPECT_EQ(before.allocations, after.allocations);
+}
+
+TEST(QueryArena, scopeShouldSetTheCurrentArenaUntilItEnds) {
+  EXPECT_EQ(nullptr, QueryArena::Current());
+
+  QueryArena outer;
+  {
+    QueryArena::Scope outerScope(outer);
+    EXPECT_EQ(&outer, QueryArena::Current());
+
+    QueryArena inner;
+    {
+      QueryArena::Scope innerScope(inner);
+      EXPECT_EQ(&inner, QueryArena::Current());
+    }
+    EXPECT_EQ(&outer, QueryArena::Current());
+  }
+
+  EXPECT_EQ(nullptr, QueryArena::Current());
+}
+
+TEST(ArenaAllocator, shouldUseTheHeapIfNoArenaIsInScope) {
+  std::vector<std::string, ArenaAllocator<std::string>> strings;
+  strings.push_back("a");
+
+  EXPECT_EQ(nullptr, strings.get_allocator().GetArena());
+}
+
+TEST(ArenaAllocator, shouldUseTheCurrentArenaByDefault) {
+  QueryArena arena;
+  QueryArena::Scope scope(arena);
+
+  std::vector<std::string, ArenaAllocator<std::string>> strings;
+  strings.push_back("a");
+
+  EXPECT_EQ(&arena, strings.get_allocator().GetArena());
+  EXPECT_NE(0, arena.GetBytesReserved());
+}
+
+TEST(ArenaAllocator, copiesOfAContainerShouldUseTheSameArena) {
+  QueryArena arena;
+  ArenaAllocator<int> allocator(&arena);
+  std::vector<int, ArenaAllocator<int>> first(allocator);
+  first.push_back(1);
+
+  auto second = first;
+
+  EXPECT_EQ(&arena, second.get_allocator().GetArena());
+  EXPECT_EQ(first, second);
+}
+}
+}
+}
+
+#endif